@@ -3,12 +3,20 @@
 
 #include <benchmark/benchmark.h>
 #include "bench_common.hpp"
+#include "decoding.hpp"
 #include "encoding.hpp"
 
 using namespace tell;
 using namespace tell::encoding;
+using namespace tell::decoding;
 using namespace tell_bench;
 
+// Second benchmark argument: 0 = reference *_into encoders, 1 = exact-size
+// cursor encoders (*_exact), so each scenario reports both side by side.
+static const char* encoder_label(const benchmark::State& state) {
+    return state.range(1) != 0 ? "exact" : "reference";
+}
+
 // --- encode_event ---
 
 static void BM_EncodeEvent(benchmark::State& state) {
@@ -21,6 +29,7 @@ static void BM_EncodeEvent(benchmark::State& state) {
     std::memset(device_id, 0x42, 16);
     std::memset(session_id, 0x43, 16);
 
+    bool exact = state.range(1) != 0;
     std::vector<uint8_t> buf;
     for (auto _ : state) {
         buf.clear();
@@ -33,15 +42,16 @@ static void BM_EncodeEvent(benchmark::State& state) {
         params.event_name_len = 11;
         params.payload = payload.data();
         params.payload_len = payload.size();
-        encode_event_into(buf, params);
+        if (exact) encode_event_exact(buf, params);
+        else encode_event_into(buf, params);
         benchmark::DoNotOptimize(buf.data());
     }
     state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
                             static_cast<int64_t>(payload.size()));
-    state.SetLabel(scenario.name);
+    state.SetLabel(std::string(scenario.name) + "/" + encoder_label(state));
 }
 
-BENCHMARK(BM_EncodeEvent)->DenseRange(0, SCENARIO_COUNT - 1);
+BENCHMARK(BM_EncodeEvent)->ArgsProduct({benchmark::CreateDenseRange(0, SCENARIO_COUNT - 1, 1), {0, 1}});
 
 // --- encode_event_data (batch of pre-encoded events) ---
 
@@ -66,18 +76,21 @@ static void BM_EncodeEventData(benchmark::State& state) {
         p.payload_len = payload.size();
     }
 
+    bool exact = state.range(1) != 0;
     std::vector<uint8_t> buf;
     buf.reserve(64 * 1024);
     for (auto _ : state) {
         buf.clear();
-        encode_event_data_into(buf, params);
+        if (exact) encode_event_data_exact(buf, params);
+        else encode_event_data_into(buf, params);
         benchmark::DoNotOptimize(buf.data());
     }
     state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
                             static_cast<int64_t>(batch_size));
+    state.SetLabel(encoder_label(state));
 }
 
-BENCHMARK(BM_EncodeEventData)->Arg(10)->Arg(100)->Arg(500);
+BENCHMARK(BM_EncodeEventData)->ArgsProduct({{10, 100, 500}, {0, 1}});
 
 // --- encode_full_batch (events -> event_data -> batch) ---
 
@@ -109,10 +122,12 @@ static void BM_EncodeFullBatch(benchmark::State& state) {
     std::vector<uint8_t> batch_buf;
     data_buf.reserve(64 * 1024);
 
+    bool exact = state.range(1) != 0;
     for (auto _ : state) {
         data_buf.clear();
         batch_buf.clear();
-        size_t start = encode_event_data_into(data_buf, params);
+        size_t start = exact ? encode_event_data_exact(data_buf, params)
+                             : encode_event_data_into(data_buf, params);
 
         BatchParams bp;
         bp.api_key = api_key;
@@ -121,15 +136,195 @@ static void BM_EncodeFullBatch(benchmark::State& state) {
         bp.batch_id = 1;
         bp.data = data_buf.data() + start;
         bp.data_len = data_buf.size() - start;
-        encode_batch_into(batch_buf, bp);
+        if (exact) encode_batch_exact(batch_buf, bp);
+        else encode_batch_into(batch_buf, bp);
+        benchmark::DoNotOptimize(batch_buf.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(scenario.events_per_batch));
+    state.SetLabel(std::string(scenario.name) + "/" + encoder_label(state));
+}
+
+BENCHMARK(BM_EncodeFullBatch)->ArgsProduct({benchmark::CreateDenseRange(0, SCENARIO_COUNT - 1, 1), {0, 1}});
+
+// --- gather_event_batch (EventData written in place behind the header) ---
+// Second arg: 0 = encode_event_batch (the frame copied into one contiguous
+// buffer), 1 = gather_event_batch (payloads referenced, not copied;
+// bytes_copied counts what is written to the head).
+
+static void BM_EncodeNestedBatch(benchmark::State& state) {
+    size_t scenario_idx = static_cast<size_t>(state.range(0));
+    const auto& scenario = SCENARIOS[scenario_idx];
+    auto payload = generate_payload(scenario.payload_size);
+
+    uint8_t api_key[16];
+    uint8_t device_id[16];
+    uint8_t session_id[16];
+    std::memset(api_key, 0xA1, 16);
+    std::memset(device_id, 0x42, 16);
+    std::memset(session_id, 0x43, 16);
+
+    std::vector<EventParams> params(scenario.events_per_batch);
+    for (auto& p : params) {
+        p.event_type = EventType::Track;
+        p.timestamp = 1700000000000;
+        p.device_id = device_id;
+        p.session_id = session_id;
+        p.service = "api";
+        p.service_len = 3;
+        p.event_name = &p - params.data() < static_cast<ptrdiff_t>(params.size() * 9 / 10)
+            ? "Page Viewed" : "Feature Used";
+        p.event_name_len = std::strlen(p.event_name);
+        p.payload = payload.data();
+        p.payload_len = payload.size();
+    }
+
+    BatchParams bp;
+    bp.api_key = api_key;
+    bp.schema_type = SchemaType::Event;
+    bp.version = 100;
+    bp.batch_id = 1;
+
+    bool gather = state.range(1) != 0;
+    std::vector<uint8_t> batch_buf;
+    GatherFrame frame;
+    for (auto _ : state) {
+        if (gather) {
+            gather_event_batch(frame, bp, params);
+            benchmark::DoNotOptimize(frame.segments.data());
+        } else {
+            batch_buf.clear();
+            encode_event_batch(batch_buf, bp, params);
+            benchmark::DoNotOptimize(batch_buf.data());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(scenario.events_per_batch));
+    size_t frame_size = gather ? frame.size() : batch_buf.size();
+    size_t copied = gather ? frame.head.size() : batch_buf.size();
+    state.counters["bytes_per_event"] = static_cast<double>(frame_size) /
+                                        static_cast<double>(scenario.events_per_batch);
+    state.counters["bytes_copied"] = static_cast<double>(copied) /
+                                     static_cast<double>(scenario.events_per_batch);
+    state.SetLabel(std::string(scenario.name) + (gather ? "/gather" : "/contiguous"));
+}
+
+BENCHMARK(BM_EncodeNestedBatch)->ArgsProduct({benchmark::CreateDenseRange(0, SCENARIO_COUNT - 1, 1), {0, 1}});
+
+// --- encode_compressed_batch (EventData compressed with LZ4) ---
+
+static void BM_EncodeCompressedBatch(benchmark::State& state) {
+    size_t scenario_idx = static_cast<size_t>(state.range(0));
+    const auto& scenario = SCENARIOS[scenario_idx];
+    auto payload = generate_payload(scenario.payload_size);
+
+    uint8_t api_key[16];
+    uint8_t device_id[16];
+    uint8_t session_id[16];
+    std::memset(api_key, 0xA1, 16);
+    std::memset(device_id, 0x42, 16);
+    std::memset(session_id, 0x43, 16);
+
+    std::vector<EventParams> params(scenario.events_per_batch);
+    for (auto& p : params) {
+        p.event_type = EventType::Track;
+        p.timestamp = 1700000000000;
+        p.device_id = device_id;
+        p.session_id = session_id;
+        p.service = "api";
+        p.service_len = 3;
+        p.event_name = "Page Viewed";
+        p.event_name_len = 11;
+        p.payload = payload.data();
+        p.payload_len = payload.size();
+    }
+
+    BatchParams bp;
+    bp.api_key = api_key;
+    bp.schema_type = SchemaType::Event;
+    bp.version = 100;
+    bp.batch_id = 1;
+
+    std::vector<uint8_t> data_buf;
+    std::vector<uint8_t> batch_buf;
+    for (auto _ : state) {
+        data_buf.clear();
+        encode_event_data_exact(data_buf, params);
+        bp.data = data_buf.data();
+        bp.data_len = data_buf.size();
+        batch_buf.clear();
+        encode_compressed_batch(batch_buf, bp, Compression::Lz4);
         benchmark::DoNotOptimize(batch_buf.data());
     }
     state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
                             static_cast<int64_t>(scenario.events_per_batch));
+    state.counters["bytes_per_event"] = static_cast<double>(batch_buf.size()) /
+                                        static_cast<double>(scenario.events_per_batch);
+    state.counters["ratio"] = static_cast<double>(BATCH_OVERHEAD + data_buf.size()) /
+                              static_cast<double>(batch_buf.size());
     state.SetLabel(scenario.name);
 }
 
-BENCHMARK(BM_EncodeFullBatch)->DenseRange(0, SCENARIO_COUNT - 1);
+BENCHMARK(BM_EncodeCompressedBatch)->DenseRange(0, SCENARIO_COUNT - 1);
+
+// --- decode (Verifier + views over a nested event batch) ---
+// Second arg: 0 = views only (trusted frame), 1 = verify then read.
+
+static void BM_DecodeBatch(benchmark::State& state) {
+    size_t scenario_idx = static_cast<size_t>(state.range(0));
+    const auto& scenario = SCENARIOS[scenario_idx];
+    auto payload = generate_payload(scenario.payload_size);
+
+    uint8_t api_key[16];
+    uint8_t device_id[16];
+    uint8_t session_id[16];
+    std::memset(api_key, 0xA1, 16);
+    std::memset(device_id, 0x42, 16);
+    std::memset(session_id, 0x43, 16);
+
+    std::vector<EventParams> params(scenario.events_per_batch);
+    for (auto& p : params) {
+        p.event_type = EventType::Track;
+        p.timestamp = 1700000000000;
+        p.device_id = device_id;
+        p.session_id = session_id;
+        p.service = "api";
+        p.service_len = 3;
+        p.event_name = "Page Viewed";
+        p.event_name_len = 11;
+        p.payload = payload.data();
+        p.payload_len = payload.size();
+    }
+
+    BatchParams bp;
+    bp.api_key = api_key;
+    bp.schema_type = SchemaType::Event;
+    bp.version = 100;
+    bp.batch_id = 1;
+
+    std::vector<uint8_t> frame;
+    encode_event_batch(frame, bp, params);
+
+    bool verify = state.range(1) != 0;
+    for (auto _ : state) {
+        if (verify && !Verifier(frame.data(), frame.size()).batch()) {
+            state.SkipWithError("frame failed verification");
+            break;
+        }
+        uint64_t sum = 0;
+        for (auto e : BatchView::root(frame.data()).event_data().events()) {
+            sum += e.timestamp() + e.payload().size + e.event_name().size();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(scenario.events_per_batch));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(frame.size()));
+    state.SetLabel(std::string(scenario.name) + (verify ? "/verified" : "/views"));
+}
+
+BENCHMARK(BM_DecodeBatch)->ArgsProduct({benchmark::CreateDenseRange(0, SCENARIO_COUNT - 1, 1), {0, 1}});
 
 // --- encode_log_entry ---
 
@@ -141,6 +336,7 @@ static void BM_EncodeLogEntry(benchmark::State& state) {
     uint8_t session_id[16];
     std::memset(session_id, 0x43, 16);
 
+    bool exact = state.range(1) != 0;
     std::vector<uint8_t> buf;
     for (auto _ : state) {
         buf.clear();
@@ -155,15 +351,16 @@ static void BM_EncodeLogEntry(benchmark::State& state) {
         params.service_len = 3;
         params.payload = payload.data();
         params.payload_len = payload.size();
-        encode_log_entry_into(buf, params);
+        if (exact) encode_log_entry_exact(buf, params);
+        else encode_log_entry_into(buf, params);
         benchmark::DoNotOptimize(buf.data());
     }
     state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
                             static_cast<int64_t>(payload.size()));
-    state.SetLabel(scenario.name);
+    state.SetLabel(std::string(scenario.name) + "/" + encoder_label(state));
 }
 
-BENCHMARK(BM_EncodeLogEntry)->DenseRange(0, SCENARIO_COUNT - 1);
+BENCHMARK(BM_EncodeLogEntry)->ArgsProduct({benchmark::CreateDenseRange(0, SCENARIO_COUNT - 1, 1), {0, 1}});
 
 // --- encode_log_batch (log entries -> log_data -> batch) ---
 
@@ -194,10 +391,12 @@ static void BM_EncodeLogBatch(benchmark::State& state) {
     std::vector<uint8_t> batch_buf;
     data_buf.reserve(64 * 1024);
 
+    bool exact = state.range(1) != 0;
     for (auto _ : state) {
         data_buf.clear();
         batch_buf.clear();
-        size_t start = encode_log_data_into(data_buf, params);
+        size_t start = exact ? encode_log_data_exact(data_buf, params)
+                             : encode_log_data_into(data_buf, params);
 
         BatchParams bp;
         bp.api_key = api_key;
@@ -206,13 +405,15 @@ static void BM_EncodeLogBatch(benchmark::State& state) {
         bp.batch_id = 1;
         bp.data = data_buf.data() + start;
         bp.data_len = data_buf.size() - start;
-        encode_batch_into(batch_buf, bp);
+        if (exact) encode_batch_exact(batch_buf, bp);
+        else encode_batch_into(batch_buf, bp);
         benchmark::DoNotOptimize(batch_buf.data());
     }
     state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
                             static_cast<int64_t>(batch_size));
+    state.SetLabel(encoder_label(state));
 }
 
-BENCHMARK(BM_EncodeLogBatch)->Arg(10)->Arg(100)->Arg(500);
+BENCHMARK(BM_EncodeLogBatch)->ArgsProduct({{10, 100, 500}, {0, 1}});
 
 BENCHMARK_MAIN();
@@ -2,10 +2,40 @@
 // SDK API hot-path benchmarks — mirrors tell-bench/benches/hot_path.rs.
 
 #include <benchmark/benchmark.h>
+#include "tell/json_escape.hpp"
 #include "tell/tell.hpp"
 
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
 using namespace tell;
 
+// Heap allocations made on the calling thread, counted by the operator new
+// replacement below and reported per iteration as "allocs" (the worker
+// thread's allocations are not included).
+static thread_local uint64_t thread_allocs = 0;
+
+// noinline keeps GCC from pairing the malloc/free across the two and
+// warning about a mismatched delete.
+__attribute__((noinline)) void* operator new(size_t n) {
+    thread_allocs++;
+    if (void* p = std::malloc(n != 0 ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+struct AllocCounter {
+    uint64_t start = thread_allocs;
+
+    void report(benchmark::State& state) const {
+        state.counters["allocs"] = static_cast<double>(thread_allocs - start) /
+                                   static_cast<double>(state.iterations());
+    }
+};
+
 // Non-routable endpoint — worker spawns but never connects.
 // Large batch size + long flush interval prevent auto-flush during bench.
 static std::unique_ptr<Tell> make_client() {
@@ -23,25 +53,44 @@ static std::unique_ptr<Tell> make_client() {
 
 static void BM_TrackNoProps(benchmark::State& state) {
     auto client = make_client();
+    AllocCounter allocs;
     for (auto _ : state) {
         client->track("user_bench_123", "Page Viewed");
     }
     state.SetItemsProcessed(state.iterations());
+    allocs.report(state);
 }
 BENCHMARK(BM_TrackNoProps);
 
+// Arguments past std::string's inline capacity (15 chars), passed the way
+// most callers do: literals and Events:: constants.
+static void BM_TrackLongNames(benchmark::State& state) {
+    auto client = make_client();
+    AllocCounter allocs;
+    for (auto _ : state) {
+        client->track("user_0123456789abcdef", Events::SUBSCRIPTION_CANCELED,
+                      Props().add("subscription_plan", "enterprise_annual"));
+    }
+    state.SetItemsProcessed(state.iterations());
+    allocs.report(state);
+}
+BENCHMARK(BM_TrackLongNames);
+
 static void BM_TrackSmallProps(benchmark::State& state) {
     auto client = make_client();
+    AllocCounter allocs;
     for (auto _ : state) {
         client->track("user_bench_123", "Page Viewed",
             Props().add("url", "/home").add("referrer", "google"));
     }
     state.SetItemsProcessed(state.iterations());
+    allocs.report(state);
 }
 BENCHMARK(BM_TrackSmallProps);
 
 static void BM_TrackLargeProps(benchmark::State& state) {
     auto client = make_client();
+    AllocCounter allocs;
     for (auto _ : state) {
         client->track("user_bench_123", "Page Viewed",
             Props()
@@ -61,9 +110,11 @@ static void BM_TrackLargeProps(benchmark::State& state) {
                 .add("first_paint_ms", 456));
     }
     state.SetItemsProcessed(state.iterations());
+    allocs.report(state);
 }
 BENCHMARK(BM_TrackLargeProps);
 
+// Arg: number of registered super props (5 typical, 20 heavy).
 static void BM_TrackWithSuperProps(benchmark::State& state) {
     auto client = make_client();
     client->register_props(
@@ -73,14 +124,116 @@ static void BM_TrackWithSuperProps(benchmark::State& state) {
             .add("platform", "web")
             .add("sdk_version", "0.1.0")
             .add("deployment_id", "deploy_abc123"));
+    for (int64_t i = 5; i < state.range(0); i++) {
+        client->register_props(Props().add("super_prop_" + std::to_string(i), "value_" + std::to_string(i)));
+    }
 
+    AllocCounter allocs;
     for (auto _ : state) {
         client->track("user_bench_123", "Page Viewed",
             Props().add("url", "/home").add("referrer", "google").add("page_type", "landing"));
     }
     state.SetItemsProcessed(state.iterations());
+    allocs.report(state);
 }
-BENCHMARK(BM_TrackWithSuperProps);
+BENCHMARK(BM_TrackWithSuperProps)->Arg(5)->Arg(20);
+
+// Large property sets passed by const& (copied into the payload) vs by
+// Props&& (the props buffer becomes the payload).
+// First arg: property count; second: 0 = borrowed, 1 = owned.
+static void BM_TrackPropsHandoff(benchmark::State& state) {
+    auto client = make_client();
+    int64_t fields = state.range(0);
+    bool owned = state.range(1) != 0;
+    std::vector<std::string> keys;
+    for (int64_t i = 0; i < fields; i++) keys.push_back("property_" + std::to_string(i));
+    AllocCounter allocs;
+    for (auto _ : state) {
+        Props props;
+        for (const auto& key : keys) props.add(key, "some reasonably long property value");
+        if (owned) {
+            client->track("user_bench_123", "Page Viewed", std::move(props));
+        } else {
+            client->track("user_bench_123", "Page Viewed", props);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    allocs.report(state);
+    state.SetLabel(owned ? "owned" : "borrowed");
+}
+BENCHMARK(BM_TrackPropsHandoff)->ArgsProduct({{16, 128}, {0, 1}});
+
+// Property values that are mostly escapes: embedded JSON, Windows paths,
+// multi-line text.
+static void BM_TrackEscapeHeavyProps(benchmark::State& state) {
+    auto client = make_client();
+    for (auto _ : state) {
+        client->track("user_bench_123", "Form Submitted",
+            Props()
+                .add("raw_body", "{\"email\":\"jane@example.com\",\"tags\":[\"a\",\"b\"]}")
+                .add("upload_path", "C:\\Users\\jane\\Documents\\report \"final\".pdf")
+                .add("comment", "line one\nline two\n\tindented \"quote\"\r\n"));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TrackEscapeHeavyProps);
+
+// Props building alone, numbers only (no client) — integer and double
+// formatting cost.
+static void BM_PropsNumeric(benchmark::State& state) {
+    AllocCounter allocs;
+    for (auto _ : state) {
+        Props props;
+        props.add("screen_width", 1920)
+            .add("screen_height", 1080)
+            .add("session_count", int64_t(42))
+            .add("bytes_sent", int64_t(1739201847))
+            .add("page_load_time_ms", 1234.5678)
+            .add("lat", 40.712776)
+            .add("lng", -74.005974)
+            .add("cart_total", 129.95)
+            .add("discount", 0.15)
+            .add("score", 0.987654321);
+        benchmark::DoNotOptimize(props.raw().data());
+    }
+    state.SetItemsProcessed(state.iterations() * 10);
+    allocs.report(state);
+}
+BENCHMARK(BM_PropsNumeric);
+
+// A cart with 3 line items: pre-serialized into a JSON string value (the
+// only option before nesting; escaped a second time) vs built nested.
+// Arg: 0 = pre-serialized string, 1 = nested.
+static void BM_PropsNested(benchmark::State& state) {
+    bool nested = state.range(0) != 0;
+    AllocCounter allocs;
+    for (auto _ : state) {
+        Props props;
+        if (nested) {
+            props.begin_object("cart").add("currency", "USD").begin_array("items");
+            for (int i = 0; i < 3; i++) {
+                props.begin_object().add("sku", "SKU-10042").add("qty", 2).add("price", 19.99).end_object();
+            }
+            props.end_array().end_object();
+        } else {
+            Props cart;
+            cart.add("currency", "USD");
+            std::string items = "[";
+            for (int i = 0; i < 3; i++) {
+                if (i > 0) items += ',';
+                items += Props().add("sku", "SKU-10042").add("qty", 2).add("price", 19.99).json();
+            }
+            items += ']';
+            cart.add("items", items);
+            props.add("cart", cart.json());
+        }
+        benchmark::DoNotOptimize(props.json().data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    allocs.report(state);
+    state.SetLabel(nested ? "nested" : "pre-serialized");
+}
+BENCHMARK(BM_PropsNested)->Arg(0)->Arg(1);
 
 // --- track burst ---
 
@@ -97,6 +250,27 @@ static void BM_TrackBurst(benchmark::State& state) {
 }
 BENCHMARK(BM_TrackBurst)->Arg(100)->Arg(1000)->Arg(10000);
 
+// --- track (multi-threaded) ---
+
+// One client shared by all benchmark threads — measures channel contention
+// as producer threads scale. Thread 0 owns setup/teardown; the benchmark
+// loop itself is barrier-synchronized across threads.
+static std::unique_ptr<Tell> shared_client;
+
+static void BM_TrackThreaded(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        shared_client = make_client();
+    }
+    for (auto _ : state) {
+        shared_client->track("user_bench_123", "Page Viewed");
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        shared_client.reset();
+    }
+}
+BENCHMARK(BM_TrackThreaded)->ThreadRange(1, 32)->UseRealTime();
+
 // --- log ---
 
 static void BM_LogError(benchmark::State& state) {
@@ -109,6 +283,29 @@ static void BM_LogError(benchmark::State& state) {
 }
 BENCHMARK(BM_LogError);
 
+// Long log messages (up to the 64 KB limit): a stack-trace-like body with a
+// newline and tab every ~100 bytes.
+static std::string long_message(size_t size) {
+    std::string message;
+    message.reserve(size);
+    while (message.size() < size) {
+        message += "\tat com.example.service.Handler.process(Handler.java:42) caused by \"timeout\"\n";
+    }
+    message.resize(size);
+    return message;
+}
+
+static void BM_LogLongMessage(benchmark::State& state) {
+    auto client = make_client();
+    auto message = long_message(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        client->log_error(message, "api");
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LogLongMessage)->Arg(1024)->Arg(16384)->Arg(65536);
+
 // --- identify ---
 
 static void BM_Identify(benchmark::State& state) {
@@ -133,4 +330,44 @@ static void BM_Revenue(benchmark::State& state) {
 }
 BENCHMARK(BM_Revenue);
 
+// --- JSON string escaping ---
+// First arg: input (0 = short id, 1 = escape-heavy, 2 = 64 KB log message).
+// Second arg: 0 = byte-at-a-time loop, 1 = json::append_escaped (SIMD scan).
+
+// The pre-SIMD loop: needs_escape per byte, bulk-copy the safe run.
+static void append_escaped_bytewise(std::vector<uint8_t>& buf, const std::string& s) {
+    size_t i = 0;
+    while (i < s.size()) {
+        size_t run_start = i;
+        while (i < s.size() && !json::needs_escape(s[i])) ++i;
+        buf.insert(buf.end(), s.begin() + static_cast<std::ptrdiff_t>(run_start),
+                   s.begin() + static_cast<std::ptrdiff_t>(i));
+        if (i < s.size()) json::append_escaped(buf, s.data() + i++, 1);
+    }
+}
+
+static void BM_EscapeString(benchmark::State& state) {
+    static const char* labels[] = {"short", "escape_heavy", "long_message"};
+    std::string input;
+    switch (state.range(0)) {
+        case 0: input = "user_bench_123"; break;
+        case 1:
+            for (int i = 0; i < 32; i++) input += "{\"k\":\"v\\n\"}\t";
+            break;
+        default: input = long_message(65536); break;
+    }
+    bool simd = state.range(1) != 0;
+    std::vector<uint8_t> buf;
+    buf.reserve(input.size() * 6);
+    for (auto _ : state) {
+        buf.clear();
+        if (simd) json::append_escaped(buf, input.data(), input.size());
+        else append_escaped_bytewise(buf, input);
+        benchmark::DoNotOptimize(buf.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+    state.SetLabel(std::string(labels[state.range(0)]) + (simd ? "/simd" : "/bytewise"));
+}
+BENCHMARK(BM_EscapeString)->ArgsProduct({{0, 1, 2}, {0, 1}});
+
 BENCHMARK_MAIN();
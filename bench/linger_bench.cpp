@@ -0,0 +1,175 @@
+// bench/linger_bench.cpp
+// End-to-end latency and throughput at fixed offered loads — fixed vs adaptive linger.
+//
+// Each event carries its enqueue time ("t", steady_clock ns); a loopback
+// server stamps arrival and records the difference. Reported counters:
+//   p50_ms / p99_ms  enqueue-to-server latency
+//   events_per_s     delivered throughput
+//   frames           number of batches sent (syscall pressure)
+
+#include <benchmark/benchmark.h>
+#include "tell/tell.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+using namespace tell;
+
+namespace {
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Loopback server that parses frames and records per-event latency.
+struct LatencyServer {
+    std::string address;
+    std::atomic<bool> stop{false};
+    std::thread thread;
+    int listen_fd = -1;
+
+    std::mutex mutex;
+    std::vector<int64_t> latencies_ns;
+    size_t frames = 0;
+
+    LatencyServer() {
+        listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        int opt = 1;
+        ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        ::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd, 8);
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        address = "127.0.0.1:" + std::to_string(ntohs(addr.sin_port));
+
+        thread = std::thread([this]() {
+            std::vector<std::thread> readers;
+            while (!stop.load(std::memory_order_relaxed)) {
+                fd_set fds;
+                FD_ZERO(&fds);
+                FD_SET(listen_fd, &fds);
+                timeval tv{0, 50000};
+                if (::select(listen_fd + 1, &fds, nullptr, nullptr, &tv) > 0) {
+                    int client_fd = ::accept(listen_fd, nullptr, nullptr);
+                    if (client_fd >= 0) readers.emplace_back(&LatencyServer::read_frames, this, client_fd);
+                }
+            }
+            for (auto& r : readers) r.join();
+        });
+    }
+
+    ~LatencyServer() {
+        stop.store(true, std::memory_order_relaxed);
+        if (thread.joinable()) thread.join();
+        if (listen_fd >= 0) ::close(listen_fd);
+    }
+
+    void read_frames(int fd) {
+        std::vector<uint8_t> acc;
+        char buf[64 * 1024];
+        for (;;) {
+            ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            acc.insert(acc.end(), buf, buf + n);
+            while (acc.size() >= 4) {
+                uint32_t len = (uint32_t(acc[0]) << 24) | (uint32_t(acc[1]) << 16) |
+                               (uint32_t(acc[2]) << 8) | uint32_t(acc[3]);
+                if (acc.size() < 4 + len) break;
+                record(acc.data() + 4, len);
+                acc.erase(acc.begin(), acc.begin() + 4 + len);
+            }
+        }
+        ::close(fd);
+    }
+
+    // Scan a frame for "t":<ns> stamps; FlatBuffer payloads are raw JSON.
+    void record(const uint8_t* data, size_t len) {
+        int64_t now = steady_ns();
+        std::string frame(reinterpret_cast<const char*>(data), len);
+        std::lock_guard<std::mutex> lock(mutex);
+        frames++;
+        for (size_t pos = frame.find("\"t\":"); pos != std::string::npos; pos = frame.find("\"t\":", pos + 4)) {
+            latencies_ns.push_back(now - std::strtoll(frame.c_str() + pos + 4, nullptr, 10));
+        }
+    }
+};
+
+double percentile_ms(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0.0;
+    size_t idx = std::min(v.size() - 1, static_cast<size_t>(p * static_cast<double>(v.size())));
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(idx), v.end());
+    return static_cast<double>(v[idx]) / 1e6;
+}
+
+} // namespace
+
+// Args: offered load (events/s), adaptive (0 = fixed batch_size + 100ms interval).
+static void BM_LingerLoad(benchmark::State& state) {
+    auto rate = static_cast<int64_t>(state.range(0));
+    bool adaptive = state.range(1) != 0;
+    constexpr auto duration = std::chrono::milliseconds(1000);
+    constexpr auto latency_bound = std::chrono::milliseconds(100);
+
+    for (auto _ : state) {
+        LatencyServer server;
+        auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+            .endpoint(server.address)
+            .batch_size(500)
+            .flush_interval(latency_bound)
+            .adaptive_linger(adaptive)
+            .max_latency(latency_bound)
+            .build();
+        auto client = Tell::create(std::move(config));
+        client->track("warmup", "Warmup");
+        client->flush();
+
+        // Pace in 1ms ticks so sleep granularity doesn't skew low rates
+        auto start = std::chrono::steady_clock::now();
+        int64_t sent = 0;
+        for (auto tick = start; tick < start + duration; tick += std::chrono::milliseconds(1)) {
+            std::this_thread::sleep_until(tick);
+            auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(tick - start).count();
+            int64_t due = rate * (elapsed_us + 1000) / 1000000;
+            for (; sent < due; sent++) {
+                client->track("user_bench_123", "Page Viewed",
+                    Props().add("t", static_cast<int64_t>(steady_ns())).add("url", "/home"));
+            }
+        }
+        client->close();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::lock_guard<std::mutex> lock(server.mutex);
+        auto& lat = server.latencies_ns;
+        state.counters["p50_ms"] = percentile_ms(lat, 0.50);
+        state.counters["p99_ms"] = percentile_ms(lat, 0.99);
+        state.counters["events_per_s"] = static_cast<double>(lat.size()) /
+            std::chrono::duration<double>(duration).count();
+        state.counters["frames"] = static_cast<double>(server.frames);
+    }
+    state.SetLabel(adaptive ? "adaptive" : "fixed");
+}
+
+BENCHMARK(BM_LingerLoad)
+    ->ArgsProduct({{100, 1000, 10000, 100000}, {0, 1}})
+    ->ArgNames({"rate", "adaptive"})
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+BENCHMARK_MAIN();
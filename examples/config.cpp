@@ -15,6 +15,22 @@ int main() {
         .max_retries(3)                                           // default: 3 retry attempts
         .close_timeout(std::chrono::milliseconds(5000))           // default: 5s graceful shutdown
         .network_timeout(std::chrono::milliseconds(30000))        // default: 30s TCP timeout
+        .staging_block_size(0)                                    // default: 0 (per-thread staging off)
+        .queue_policy(tell::QueuePolicy::DropOldest)              // default: drop oldest when full
+        .queue_capacity(10000)                                    // default: 10000 queued messages
+        .queue_max_bytes(0)                                       // default: 0 (no byte budget)
+        .queue_block_timeout(std::chrono::milliseconds(100))      // default: 100ms (QueuePolicy::Block)
+        .encode_on_producer(false)                                // default: worker encodes events
+        .workers(1)                                               // default: 1 worker thread / connection
+        .priority_log_level(tell::LogLevel::Critical)             // default: Emergency..Critical sent immediately
+        .bulk_log_level(tell::LogLevel::Debug)                    // default: Debug/Trace shed first
+        .max_batch_bytes(0)                                       // default: 0 (no encoded-size flush)
+        .max_frame_bytes(0)                                       // default: 0 (frames never split)
+        .adaptive_linger(false)                                   // default: fixed batch_size / flush_interval
+        .max_latency(std::chrono::milliseconds(200))              // default: 200ms (adaptive linger bound)
+        .min_batch_size(1)                                        // default: 1 (adaptive linger bound)
+        .compression(tell::Compression::None)                     // default: batches sent uncompressed
+        .compression_min_bytes(1024)                              // default: compress batches from 1 KB
         .on_error([](const tell::TellError& e) {                  // default: errors are silent
             std::cerr << "[Tell] " << e.what() << std::endl;
         })
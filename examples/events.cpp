@@ -14,6 +14,12 @@ int main() {
     client->track("user_123", "Page Viewed",
         tell::Props().add("url", "/home").add("referrer", "google"));
 
+    // Nested objects and arrays
+    client->track("user_123", "Checkout Started",
+        tell::Props()
+            .begin_object("cart").add("items", 2).add("total", 59.98, 2).end_object()
+            .add("coupons", {"SPRING", "VIP"}));
+
     // Identify users
     client->identify("user_123",
         tell::Props().add("name", "Jane").add("plan", "pro"));
@@ -7,12 +7,35 @@
 #include "error.hpp"
 #include "props.hpp"
 #include "types.hpp"
+#include <cstddef>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace tell {
 
+// How the records covered by a flush/close fared. Ordered by severity:
+// a result reports the worst outcome of any batch it covers.
+enum class FlushOutcome : uint8_t {
+    Sent,            // every batch was written to the connection
+    QueuedForRetry,  // a send failed; the batch is being retried in the background
+    Dropped,         // records were discarded (queue policy, send failure, closed client)
+};
+
+// Result of flush_async()/close_async(). Covers everything the worker(s)
+// handled since the previous flush or close completed.
+struct FlushResult {
+    FlushOutcome outcome = FlushOutcome::Sent;
+    size_t events = 0;   // events sent or queued for retry
+    size_t logs = 0;     // logs sent or queued for retry
+    size_t dropped = 0;  // records discarded
+};
+
+using FlushCallback = std::function<void(const FlushResult&)>;
+
 // The Tell analytics client.
 //
 // Created via Tell::create(config). Ready to use immediately — no separate
@@ -37,49 +60,74 @@ public:
 
     // --- Events (§2.2) ---
 
+    // String arguments are taken as std::string_view: literals, const char*
+    // constants such as Events::PAGE_VIEWED and std::string all pass without
+    // building a temporary std::string, and are validated and encoded from
+    // the view.
+
+    // Every method taking Props has a Props&& overload: a temporary such as
+    // Props().add("url", "/home") hands its buffer over and becomes the
+    // payload, instead of being copied into a new one.
+
     // Track a user action. Never blocks, never throws.
-    void track(const std::string& user_id, const std::string& event_name,
+    void track(std::string_view user_id, std::string_view event_name,
                const Props& properties = Props());
+    void track(std::string_view user_id, std::string_view event_name, Props&& properties);
 
     // Identify a user with optional traits.
-    void identify(const std::string& user_id, const Props& traits = Props());
+    void identify(std::string_view user_id, const Props& traits = Props());
+    void identify(std::string_view user_id, Props&& traits);
 
     // Associate a user with a group.
-    void group(const std::string& user_id, const std::string& group_id,
+    void group(std::string_view user_id, std::string_view group_id,
                const Props& properties = Props());
+    void group(std::string_view user_id, std::string_view group_id, Props&& properties);
 
     // Track a revenue event.
-    void revenue(const std::string& user_id, double amount,
-                 const std::string& currency, const std::string& order_id,
+    void revenue(std::string_view user_id, double amount,
+                 std::string_view currency, std::string_view order_id,
                  const Props& properties = Props());
+    void revenue(std::string_view user_id, double amount,
+                 std::string_view currency, std::string_view order_id,
+                 Props&& properties);
 
     // Link two user identities.
-    void alias(const std::string& previous_id, const std::string& user_id);
+    void alias(std::string_view previous_id, std::string_view user_id);
 
     // --- Logging (§2.3) ---
 
     // Send a structured log entry.
-    void log(LogLevel level, const std::string& message,
-             const std::string& service = "app", const Props& data = Props());
+    void log(LogLevel level, std::string_view message,
+             std::string_view service = "app", const Props& data = Props());
+    void log(LogLevel level, std::string_view message, std::string_view service, Props&& data);
 
-    void log_emergency(const std::string& message, const std::string& service = "app",
+    void log_emergency(std::string_view message, std::string_view service = "app",
                        const Props& data = Props());
-    void log_alert(const std::string& message, const std::string& service = "app",
+    void log_emergency(std::string_view message, std::string_view service, Props&& data);
+    void log_alert(std::string_view message, std::string_view service = "app",
                    const Props& data = Props());
-    void log_critical(const std::string& message, const std::string& service = "app",
+    void log_alert(std::string_view message, std::string_view service, Props&& data);
+    void log_critical(std::string_view message, std::string_view service = "app",
                       const Props& data = Props());
-    void log_error(const std::string& message, const std::string& service = "app",
+    void log_critical(std::string_view message, std::string_view service, Props&& data);
+    void log_error(std::string_view message, std::string_view service = "app",
                    const Props& data = Props());
-    void log_warning(const std::string& message, const std::string& service = "app",
+    void log_error(std::string_view message, std::string_view service, Props&& data);
+    void log_warning(std::string_view message, std::string_view service = "app",
                      const Props& data = Props());
-    void log_notice(const std::string& message, const std::string& service = "app",
+    void log_warning(std::string_view message, std::string_view service, Props&& data);
+    void log_notice(std::string_view message, std::string_view service = "app",
                     const Props& data = Props());
-    void log_info(const std::string& message, const std::string& service = "app",
+    void log_notice(std::string_view message, std::string_view service, Props&& data);
+    void log_info(std::string_view message, std::string_view service = "app",
                   const Props& data = Props());
-    void log_debug(const std::string& message, const std::string& service = "app",
+    void log_info(std::string_view message, std::string_view service, Props&& data);
+    void log_debug(std::string_view message, std::string_view service = "app",
                    const Props& data = Props());
-    void log_trace(const std::string& message, const std::string& service = "app",
+    void log_debug(std::string_view message, std::string_view service, Props&& data);
+    void log_trace(std::string_view message, std::string_view service = "app",
                    const Props& data = Props());
+    void log_trace(std::string_view message, std::string_view service, Props&& data);
 
     // --- Super Properties ---
 
@@ -87,7 +135,7 @@ public:
     void register_props(const Props& properties);
 
     // Remove a super property by key.
-    void unregister(const std::string& key);
+    void unregister(std::string_view key);
 
     // --- Session ---
 
@@ -96,16 +144,36 @@ public:
 
     // --- Lifecycle (§2.4) ---
 
-    // Force-send all queued batches, blocks until complete.
+    // Force-send all queued batches, blocks up to close_timeout.
     void flush();
 
     // Flush + close connection, blocks up to close_timeout.
     void close();
 
+    // Non-blocking variants. The future (or callback) completes once every
+    // worker has flushed; callbacks run on a worker thread, so keep them
+    // short and don't call flush()/close() from them.
+    std::future<FlushResult> flush_async();
+    void flush_async(FlushCallback callback);
+    std::future<FlushResult> close_async();
+    void close_async(FlushCallback callback);
+
 private:
     explicit Tell(TellConfig config);
     struct Inner;
     std::unique_ptr<Inner> inner_;
+
+    // Shared by the const Props& and Props&& overloads; `owned` is the same
+    // object as the props argument when the caller handed it over, else null.
+    void send_track(std::string_view user_id, std::string_view event_name,
+                    const Props& properties, Props* owned);
+    void send_identify(std::string_view user_id, const Props& traits, Props* owned);
+    void send_group(std::string_view user_id, std::string_view group_id,
+                    const Props& properties, Props* owned);
+    void send_revenue(std::string_view user_id, double amount, std::string_view currency,
+                      std::string_view order_id, const Props& properties, Props* owned);
+    void send_log(LogLevel level, std::string_view message, std::string_view service,
+                  const Props& data, Props* owned);
 };
 
 } // namespace tell
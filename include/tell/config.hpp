@@ -4,8 +4,10 @@
 #pragma once
 
 #include "error.hpp"
+#include "types.hpp"
 #include <array>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <string>
 
@@ -13,6 +15,15 @@ namespace tell {
 
 class TellConfigBuilder;
 
+// What the worker channel does with a new record when it is at capacity.
+// Flush and close signals use a separate path and are never dropped.
+enum class QueuePolicy : uint8_t {
+    DropOldest,  // evict the oldest queued record (default)
+    DropNewest,  // reject the incoming record
+    Block,       // wait up to queue_block_timeout for room, then drop the record
+    Sample,      // past half capacity, admit records with falling probability
+};
+
 // Configuration for the Tell SDK.
 class TellConfig {
 public:
@@ -32,6 +43,22 @@ public:
     uint32_t max_retries() const noexcept { return max_retries_; }
     std::chrono::milliseconds close_timeout() const noexcept { return close_timeout_; }
     std::chrono::milliseconds network_timeout() const noexcept { return network_timeout_; }
+    size_t staging_block_size() const noexcept { return staging_block_size_; }
+    QueuePolicy queue_policy() const noexcept { return queue_policy_; }
+    size_t queue_capacity() const noexcept { return queue_capacity_; }
+    size_t queue_max_bytes() const noexcept { return queue_max_bytes_; }
+    std::chrono::milliseconds queue_block_timeout() const noexcept { return queue_block_timeout_; }
+    bool encode_on_producer() const noexcept { return encode_on_producer_; }
+    size_t workers() const noexcept { return workers_; }
+    LogLevel priority_log_level() const noexcept { return priority_log_level_; }
+    LogLevel bulk_log_level() const noexcept { return bulk_log_level_; }
+    size_t max_batch_bytes() const noexcept { return max_batch_bytes_; }
+    size_t max_frame_bytes() const noexcept { return max_frame_bytes_; }
+    bool adaptive_linger() const noexcept { return adaptive_linger_; }
+    std::chrono::milliseconds max_latency() const noexcept { return max_latency_; }
+    size_t min_batch_size() const noexcept { return min_batch_size_; }
+    Compression compression() const noexcept { return compression_; }
+    size_t compression_min_bytes() const noexcept { return compression_min_bytes_; }
     const ErrorCallback& on_error() const noexcept { return on_error_; }
 
 private:
@@ -45,6 +72,22 @@ private:
     uint32_t max_retries_ = 3;
     std::chrono::milliseconds close_timeout_{5000};
     std::chrono::milliseconds network_timeout_{30000};
+    size_t staging_block_size_ = 0;
+    QueuePolicy queue_policy_ = QueuePolicy::DropOldest;
+    size_t queue_capacity_ = 10000;
+    size_t queue_max_bytes_ = 0;
+    std::chrono::milliseconds queue_block_timeout_{100};
+    bool encode_on_producer_ = false;
+    size_t workers_ = 1;
+    LogLevel priority_log_level_ = LogLevel::Critical;
+    LogLevel bulk_log_level_ = LogLevel::Debug;
+    size_t max_batch_bytes_ = 0;
+    size_t max_frame_bytes_ = 0;
+    bool adaptive_linger_ = false;
+    std::chrono::milliseconds max_latency_{200};
+    size_t min_batch_size_ = 1;
+    Compression compression_ = Compression::None;
+    size_t compression_min_bytes_ = 1024;
     ErrorCallback on_error_;
 };
 
@@ -60,9 +103,71 @@ public:
     TellConfigBuilder& max_retries(uint32_t retries);
     TellConfigBuilder& close_timeout(std::chrono::milliseconds timeout);
     TellConfigBuilder& network_timeout(std::chrono::milliseconds timeout);
+
+    // Stage up to `size` events/logs per producer thread and hand them to the
+    // worker as one block (on full, flush_interval, flush() or close()).
+    // 0 disables staging — every call is handed off individually (default).
+    TellConfigBuilder& staging_block_size(size_t size);
+
+    // Backpressure for the worker channel: policy at capacity, capacity in
+    // messages, optional byte budget (0 = unlimited), and the wait bound for
+    // QueuePolicy::Block. The capacity applies per record type: events and
+    // logs each queue up to queue_capacity, as do staged blocks when
+    // staging_block_size is set. The byte budget covers all of them.
+    TellConfigBuilder& queue_policy(QueuePolicy policy);
+    TellConfigBuilder& queue_capacity(size_t messages);
+    TellConfigBuilder& queue_max_bytes(size_t bytes);
+    TellConfigBuilder& queue_block_timeout(std::chrono::milliseconds timeout);
+
+    // Encode each event's FlatBuffer table on the calling thread (into a
+    // per-thread arena) instead of on the worker. Spreads encoding CPU across
+    // producer cores; the worker only assembles batches. Off by default.
+    TellConfigBuilder& encode_on_producer(bool enabled);
+
+    // Number of independent worker threads, each with its own queue and TCP
+    // connection. Events are routed by user_id (per-user order is kept),
+    // logs round-robin. Default 1.
+    TellConfigBuilder& workers(size_t count);
+
+    // Log lanes by severity. Logs at priority_log_level or more severe skip
+    // batching and the data queue: they are sent as soon as the worker wakes
+    // and are never shed to make room for other records (default Critical:
+    // Emergency/Alert/Critical). The lane is still bounded: past
+    // queue_capacity logs, or the queue_max_bytes budget, they are dropped.
+    // Logs at bulk_log_level or less severe are shed first — dropped once the
+    // queue is half full (default Debug: Debug/Trace).
+    TellConfigBuilder& priority_log_level(LogLevel level);
+    TellConfigBuilder& bulk_log_level(LogLevel level);
+
+    // Size limits on encoded batches. A batch is flushed once it holds
+    // batch_size records or max_batch_bytes, whichever comes first; a flush
+    // larger than max_frame_bytes is split into several frames, and a single
+    // record that cannot fit a frame is dropped with a serialization error.
+    // 0 disables either limit; both are off by default, so records of any
+    // size are sent as before.
+    TellConfigBuilder& max_batch_bytes(size_t bytes);
+    TellConfigBuilder& max_frame_bytes(size_t bytes);
+
+    // Adaptive linger: instead of waiting for batch_size or flush_interval,
+    // the worker measures arrival rate and send cost and flushes as soon as a
+    // batch amortizes its send — immediately at low traffic, larger batches
+    // under load. Bounds: no record waits longer than max_latency, batches
+    // hold at least min_batch_size records (unless max_latency expires) and
+    // at most batch_size. Off by default.
+    TellConfigBuilder& adaptive_linger(bool enabled);
+    TellConfigBuilder& max_latency(std::chrono::milliseconds latency);
+    TellConfigBuilder& min_batch_size(size_t size);
+
+    // Compress each batch's data with the given codec (the server must
+    // support it). Batches whose encoded data is under compression_min_bytes,
+    // or that would not shrink, are sent uncompressed. Defaults: None, 1 KB.
+    TellConfigBuilder& compression(Compression codec);
+    TellConfigBuilder& compression_min_bytes(size_t bytes);
+
     TellConfigBuilder& on_error(TellConfig::ErrorCallback callback);
 
-    // Build the config. Throws TellError on invalid API key.
+    // Build the config. Throws TellError on invalid API key, queue capacity, worker
+    // count, overlapping log lanes or inconsistent batch limits.
     TellConfig build() const;
 
 private:
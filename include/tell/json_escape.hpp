@@ -0,0 +1,171 @@
+// include/tell/json_escape.hpp
+// JSON string escaping shared by Props and the client — SIMD scan for the
+// next byte that needs escaping (AVX2 picked at runtime, SSE2, scalar).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TELL_JSON_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define TELL_JSON_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace tell {
+namespace json {
+
+// '"', '\\' and control bytes below 0x20 cannot appear raw in a JSON string.
+inline bool needs_escape(char c) {
+    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+namespace detail {
+
+// Each finder returns the index of the first byte in s[i, len) that needs
+// escaping, or len if there is none.
+
+inline size_t find_escape_scalar(const char* s, size_t i, size_t len) {
+    while (i < len && !needs_escape(s[i])) ++i;
+    return i;
+}
+
+#if TELL_JSON_SSE2
+
+inline unsigned lowest_bit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// Unsigned v <= 0x1F is max(v, 0x1F) == 0x1F; SSE2 has no unsigned compare.
+inline size_t find_escape_sse2(const char* s, size_t i, size_t len) {
+    const __m128i ctrl = _mm_set1_epi8(0x1F);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        if (mask != 0) return i + lowest_bit(mask);
+    }
+    return find_escape_scalar(s, i, len);
+}
+
+#endif
+
+#if TELL_JSON_AVX2
+
+__attribute__((target("avx2")))
+inline size_t find_escape_avx2(const char* s, size_t i, size_t len) {
+    const __m256i ctrl = _mm256_set1_epi8(0x1F);
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl), ctrl),
+                                      _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                                                      _mm256_cmpeq_epi8(v, backslash)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+        if (mask != 0) return i + lowest_bit(mask);
+    }
+    return find_escape_sse2(s, i, len);
+}
+
+// Checked once per process. __builtin_cpu_init makes this safe from static
+// initializers that run before the CPU model is set up.
+inline bool has_avx2() {
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+}
+
+#endif
+
+} // namespace detail
+
+// Index of the first byte in s[i, len) that needs escaping, or len. Strings
+// shorter than one vector are scanned a byte at a time.
+inline size_t find_escape(const char* s, size_t i, size_t len) {
+#if TELL_JSON_AVX2
+    if (len - i >= 32 && detail::has_avx2()) return detail::find_escape_avx2(s, i, len);
+#endif
+#if TELL_JSON_SSE2
+    return detail::find_escape_sse2(s, i, len);
+#else
+    return detail::find_escape_scalar(s, i, len);
+#endif
+}
+
+// Append s to buf as the inside of a JSON string (no quotes). Safe runs are
+// copied straight into buf, which is sized for an escape-free string up
+// front and grown only when escapes need the room; UTF-8 passes through.
+// Buffer is std::vector<uint8_t> or anything with its data/size/resize.
+template <typename Buffer>
+void append_escaped(Buffer& buf, const char* s, size_t len) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    size_t out = buf.size();
+    buf.resize(out + len);
+    uint8_t* op = buf.data() + out;
+    size_t i = 0;
+    for (;;) {
+        size_t run_end = find_escape(s, i, len);
+        if (run_end > i) std::memcpy(op, s + i, run_end - i);
+        op += run_end - i;
+        if (run_end == len) break;
+
+        // An escape writes at most 6 bytes for 1; grow to fit it, the rest of
+        // the input as-is, and half again what is written for later escapes
+        size_t written = static_cast<size_t>(op - buf.data());
+        size_t need = written + 6 + (len - run_end - 1);
+        if (need > buf.size()) {
+            buf.resize(need + (written - out) / 2);
+            op = buf.data() + written;
+        }
+
+        uint8_t c = static_cast<uint8_t>(s[run_end]);
+        char short_form = 0;
+        switch (c) {
+            case '"':  short_form = '"'; break;
+            case '\\': short_form = '\\'; break;
+            case '\b': short_form = 'b'; break;
+            case '\f': short_form = 'f'; break;
+            case '\n': short_form = 'n'; break;
+            case '\r': short_form = 'r'; break;
+            case '\t': short_form = 't'; break;
+            default: break;
+        }
+        *op++ = '\\';
+        if (short_form != 0) {
+            *op++ = static_cast<uint8_t>(short_form);
+        } else {
+            op[0] = 'u';
+            op[1] = '0';
+            op[2] = '0';
+            op[3] = static_cast<uint8_t>(HEX[c >> 4]);
+            op[4] = static_cast<uint8_t>(HEX[c & 15]);
+            op += 5;
+        }
+        i = run_end + 1;
+    }
+    buf.resize(static_cast<size_t>(op - buf.data()));
+}
+
+} // namespace json
+} // namespace tell
@@ -0,0 +1,108 @@
+// include/tell/json_number.hpp
+// JSON number formatting shared by Props and the client — std::to_chars, so
+// no locale lookups, no format-string parsing and no heap allocation.
+
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if !defined(__cpp_lib_to_chars)
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+namespace tell {
+namespace json {
+
+// Most digits append_fixed writes after the decimal point.
+constexpr int MAX_FIXED_DECIMALS = 17;
+
+namespace detail {
+
+template <typename Buffer>
+void append_chars(Buffer& buf, const char* first, const char* last) {
+    size_t at = buf.size();
+    size_t n = static_cast<size_t>(last - first);
+    buf.resize(at + n);
+    std::memcpy(buf.data() + at, first, n);
+}
+
+// NaN and infinity have no JSON spelling.
+template <typename Buffer>
+void append_null(Buffer& buf) {
+    static constexpr char NULL_LITERAL[] = "null";
+    append_chars(buf, NULL_LITERAL, NULL_LITERAL + 4);
+}
+
+#if !defined(__cpp_lib_to_chars)
+// Standard libraries without floating-point to_chars: fewest %.*g digits that
+// read back to the same value, with a locale's decimal comma put right.
+template <typename T>
+char* format_shortest(char* first, T value) {
+    int n = 0;
+    for (int digits = std::is_same<T, float>::value ? 6 : 15; digits <= 17; digits++) {
+        n = std::snprintf(first, 32, "%.*g", digits, static_cast<double>(value));
+        if (static_cast<T>(std::strtod(first, nullptr)) == value) break;
+    }
+    for (int i = 0; i < n; i++) {
+        if (first[i] == ',') first[i] = '.';
+    }
+    return first + n;
+}
+#endif
+
+} // namespace detail
+
+// The writers below take std::vector<uint8_t> or anything with its
+// data/size/resize.
+
+// Integers, written in full.
+template <typename Buffer, typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+void append_integer(Buffer& buf, T value) {
+    char tmp[24];
+    auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    detail::append_chars(buf, tmp, result.ptr);
+}
+
+// Shortest digits that read back as the same double (or float): 0.1 stays
+// "0.1", 1234567.891 keeps every digit, whole numbers print without ".0".
+// Non-finite values are written as null.
+template <typename Buffer, typename T,
+          typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+void append_shortest(Buffer& buf, T value) {
+    if (!std::isfinite(value)) return detail::append_null(buf);
+    char tmp[32];
+#if defined(__cpp_lib_to_chars)
+    char* end = std::to_chars(tmp, tmp + sizeof(tmp), value).ptr;
+#else
+    char* end = detail::format_shortest(tmp, value);
+#endif
+    detail::append_chars(buf, tmp, end);
+}
+
+// Fixed-point with exactly `decimals` digits after the point (clamped to
+// 0..MAX_FIXED_DECIMALS), e.g. 49.9 with 2 decimals is "49.90".
+template <typename Buffer>
+void append_fixed(Buffer& buf, double value, int decimals) {
+    if (!std::isfinite(value)) return detail::append_null(buf);
+    decimals = decimals < 0 ? 0 : decimals > MAX_FIXED_DECIMALS ? MAX_FIXED_DECIMALS : decimals;
+    char tmp[330 + MAX_FIXED_DECIMALS];  // sign, 309 integer digits of DBL_MAX, point
+#if defined(__cpp_lib_to_chars)
+    char* end = std::to_chars(tmp, tmp + sizeof(tmp), value, std::chars_format::fixed, decimals).ptr;
+#else
+    int n = std::snprintf(tmp, sizeof(tmp), "%.*f", decimals, value);
+    for (int i = 0; i < n; i++) {
+        if (tmp[i] == ',') tmp[i] = '.';
+    }
+    char* end = tmp + n;
+#endif
+    detail::append_chars(buf, tmp, end);
+}
+
+} // namespace json
+} // namespace tell
@@ -3,10 +3,17 @@
 
 #pragma once
 
+#include "json_escape.hpp"
+#include "json_number.hpp"
+#include "small_buffer.hpp"
+
 #include <cstdint>
-#include <cstdio>
 #include <cstring>
+#include <initializer_list>
 #include <string>
+#include <type_traits>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace tell {
@@ -14,135 +21,307 @@ namespace tell {
 // Pre-serialized JSON properties buffer.
 //
 // Writes JSON bytes directly into a buffer, skipping any intermediate
-// JSON DOM. Each string value is safely escaped.
+// JSON DOM. Each string value is safely escaped. Typical property sets are
+// built in inline storage, so an empty or small Props never allocates.
+//
+// Objects and arrays nest: begin_object/begin_array open one, the adds
+// that follow go inside it, and end_object/end_array close it. Inside an
+// array keys are ignored; push(value) appends an element.
 //
 // Example:
 //   auto props = Props().add("url", "/home").add("status", 200);
+//   auto cart = Props()
+//       .begin_object("cart").add("items", 3).add("total", 59.97, 2).end_object()
+//       .add("tags", {"sale", "gift"});
 class Props {
 public:
-    Props() { buf_.reserve(256); }
+    // Property sets up to this many JSON bytes (braces included) are built
+    // without touching the heap; larger ones spill once and keep growing.
+    static constexpr size_t INLINE_BYTES = 256;
 
-    Props& add(const std::string& key, const std::string& value) {
-        begin_field(key);
-        buf_.push_back('"');
-        write_escaped(value.data(), value.size());
-        buf_.push_back('"');
+    // Deepest nesting begin_object/begin_array open; past it they are
+    // ignored, along with the end_object/end_array that closes each, and
+    // the adds stay in the enclosing container.
+    static constexpr size_t MAX_DEPTH = 64;
+
+    Props() { clear(); }
+
+    Props(const Props&) = default;
+    Props& operator=(const Props&) = default;
+
+    // A moved-from Props is left empty ("{}") and can be reused.
+    Props(Props&& other) noexcept
+        : buf_(std::move(other.buf_)), arrays_(other.arrays_), depth_(other.depth_),
+          ignored_(other.ignored_), count_(other.count_) {
+        other.clear();
+    }
+
+    Props& operator=(Props&& other) noexcept {
+        if (this != &other) {
+            buf_ = std::move(other.buf_);
+            arrays_ = other.arrays_;
+            depth_ = other.depth_;
+            ignored_ = other.ignored_;
+            count_ = other.count_;
+            other.clear();
+        }
         return *this;
     }
 
-    Props& add(const std::string& key, const char* value) {
+    // Keys and string values are taken as views and escaped straight into
+    // the buffer; literals and std::string need no temporary.
+    Props& add(std::string_view key, std::string_view value) & {
         begin_field(key);
-        buf_.push_back('"');
-        write_escaped(value, std::strlen(value));
-        buf_.push_back('"');
-        return *this;
+        write_value(value);
+        return end_field();
     }
 
-    Props& add(const std::string& key, int64_t value) {
+    // Keeps literals from converting to bool. A null pointer is written as null.
+    Props& add(std::string_view key, const char* value) & {
         begin_field(key);
-        char tmp[24];
-        int n = std::snprintf(tmp, sizeof(tmp), "%lld", static_cast<long long>(value));
-        if (n > 0) buf_.insert(buf_.end(), tmp, tmp + n);
-        return *this;
+        write_value(value);
+        return end_field();
     }
 
-    Props& add(const std::string& key, int value) {
+    Props& add(std::string_view key, int64_t value) & {
         begin_field(key);
-        char tmp[16];
-        int n = std::snprintf(tmp, sizeof(tmp), "%d", value);
-        if (n > 0) buf_.insert(buf_.end(), tmp, tmp + n);
-        return *this;
+        write_value(value);
+        return end_field();
     }
 
-    Props& add(const std::string& key, double value) {
+    Props& add(std::string_view key, uint64_t value) & {
         begin_field(key);
-        char tmp[64];
-        int n = std::snprintf(tmp, sizeof(tmp), "%g", value);
-        if (n > 0) buf_.insert(buf_.end(), tmp, tmp + n);
-        return *this;
+        write_value(value);
+        return end_field();
     }
 
-    Props& add(const std::string& key, bool value) {
+    Props& add(std::string_view key, int value) & {
         begin_field(key);
-        if (value) {
-            const char* t = "true";
-            buf_.insert(buf_.end(), t, t + 4);
-        } else {
-            const char* f = "false";
-            buf_.insert(buf_.end(), f, f + 5);
-        }
-        return *this;
+        write_value(value);
+        return end_field();
+    }
+
+    // Shortest digits that round-trip (no 6-digit %g truncation); NaN and
+    // infinity are written as null.
+    Props& add(std::string_view key, double value) & {
+        begin_field(key);
+        write_value(value);
+        return end_field();
+    }
+
+    Props& add(std::string_view key, float value) & {
+        begin_field(key);
+        write_value(value);
+        return end_field();
+    }
+
+    // Fixed-point with exactly `decimals` digits after the point, e.g.
+    // add("price", 49.9, 2) writes 49.90.
+    Props& add(std::string_view key, double value, int decimals) & {
+        begin_field(key);
+        json::append_fixed(buf_, value, decimals);
+        return end_field();
+    }
+
+    Props& add(std::string_view key, bool value) & {
+        begin_field(key);
+        write_value(value);
+        return end_field();
+    }
+
+    // Arrays of any value type above, written element by element:
+    // add("ids", ids.data(), ids.size()), add("scores", scores_vector),
+    // add("tags", {"a", "b"}).
+    template <typename T>
+    Props& add(std::string_view key, const T* values, size_t count) & {
+        return add_array(key, values, values + count);
+    }
+
+    template <typename T>
+    Props& add(std::string_view key, const std::vector<T>& values) & {
+        return add_array(key, values.begin(), values.end());
+    }
+
+    template <typename T>
+    Props& add(std::string_view key, std::initializer_list<T> values) & {
+        return add_array(key, values.begin(), values.end());
+    }
+
+    // Open a nested object or array under `key` (ignored inside an array),
+    // up to MAX_DEPTH levels.
+    Props& begin_object(std::string_view key = {}) & { return open(key, false); }
+    Props& begin_array(std::string_view key = {}) & { return open(key, true); }
+
+    // Close the innermost open object or array. The bytes are already in
+    // place, so this writes nothing; a call that doesn't match the
+    // innermost container is ignored. Containers still open when the
+    // Props is read are closed implicitly.
+    Props& end_object() & { return close(false); }
+    Props& end_array() & { return close(true); }
+
+    // Append an element to the innermost open array; takes the same values
+    // as add. Outside an array it is written under an empty key.
+    template <typename... Args>
+    Props& push(Args&&... args) & {
+        return add(std::string_view(), std::forward<Args>(args)...);
+    }
+
+    // Same calls on a temporary, e.g. track(..., Props().add("url", "/home")):
+    // the chain stays an rvalue so the Props&& client overloads take it.
+    template <typename... Args>
+    Props&& add(Args&&... args) && {
+        add(std::forward<Args>(args)...);
+        return std::move(*this);
     }
 
-    // Finish building and return the JSON bytes as "{...}".
+    template <typename T>
+    Props&& add(std::string_view key, std::initializer_list<T> values) && {
+        add(key, values);
+        return std::move(*this);
+    }
+
+    Props&& begin_object(std::string_view key = {}) && { return std::move(begin_object(key)); }
+    Props&& begin_array(std::string_view key = {}) && { return std::move(begin_array(key)); }
+    Props&& end_object() && { return std::move(end_object()); }
+    Props&& end_array() && { return std::move(end_array()); }
+
+    template <typename... Args>
+    Props&& push(Args&&... args) && {
+        push(std::forward<Args>(args)...);
+        return std::move(*this);
+    }
+
+    // The finished JSON object, "{...}", read in place.
+    std::string_view json() const noexcept {
+        return std::string_view(reinterpret_cast<const char*>(buf_.data()), buf_.size());
+    }
+
+    // Copy of json() as bytes.
     std::vector<uint8_t> to_json_bytes() const {
-        std::vector<uint8_t> result;
-        result.reserve(buf_.size() + 2);
-        result.push_back('{');
-        result.insert(result.end(), buf_.begin(), buf_.end());
-        result.push_back('}');
-        return result;
+        return std::vector<uint8_t>(buf_.data(), buf_.data() + buf_.size());
     }
 
+    // Move the finished JSON out as bytes, with capacity for at least
+    // `capacity` bytes. Spilled storage is handed over without copying.
+    // The Props is left empty.
+    std::vector<uint8_t> take_json_bytes(size_t capacity = 0) && {
+        auto bytes = buf_.release(capacity);
+        clear();
+        return bytes;
+    }
+
+    // Top-level fields; a nested object or array counts as one.
     bool empty() const noexcept { return count_ == 0; }
     size_t size() const noexcept { return count_; }
 
-    // Access raw inner bytes (without braces), for merging.
-    const std::vector<uint8_t>& raw() const noexcept { return buf_; }
+    // Inner bytes (without braces), for merging.
+    std::string_view raw() const noexcept { return json().substr(1, buf_.size() - 2); }
 
 private:
-    std::vector<uint8_t> buf_;
+    // Always complete JSON: '{', the fields so far, then the closing bytes
+    // of every open container, innermost first, and the final '}'. Each add
+    // writes over that tail and puts it back.
+    detail::SmallBuffer<INLINE_BYTES> buf_;
+    uint64_t arrays_ = 0;  // bit d set: the container at depth d (0 = outermost open) is an array
+    uint32_t depth_ = 0;   // open containers
+    uint32_t ignored_ = 0; // begins past MAX_DEPTH whose ends are still to come
     size_t count_ = 0;
 
-    void begin_field(const std::string& key) {
-        if (count_ > 0) buf_.push_back(',');
-        buf_.push_back('"');
-        write_escaped(key.data(), key.size());
-        buf_.push_back('"');
+    bool in_array() const noexcept { return depth_ > 0 && (arrays_ >> (depth_ - 1) & 1) != 0; }
+
+    // Strip the tail, then write the separator and, in an object, the key.
+    // Flat props only ever have the final '}' to strip; nested, the byte
+    // before the tail is an opening '{'/'[' exactly when the innermost
+    // container is still empty.
+    void begin_field(std::string_view key) {
+        if (depth_ == 0) {
+            buf_.pop_back();
+            if (count_++ > 0) buf_.push_back(',');
+        } else {
+            buf_.resize(buf_.size() - depth_ - 1);
+            uint8_t last = buf_.data()[buf_.size() - 1];
+            if (last != '{' && last != '[') buf_.push_back(',');
+            if (in_array()) return;
+        }
+        write_string(key.data(), key.size());
         buf_.push_back(':');
-        count_++;
-    }
-
-    static bool needs_escape(char c) {
-        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
-    }
-
-    void write_escaped(const char* s, size_t len) {
-        // Fast path: bulk-copy runs of safe characters.
-        size_t i = 0;
-        while (i < len) {
-            // Find next char that needs escaping
-            size_t run_start = i;
-            while (i < len && !needs_escape(s[i])) ++i;
-
-            // Bulk-copy the safe run
-            if (i > run_start) {
-                buf_.insert(buf_.end(),
-                    reinterpret_cast<const uint8_t*>(s + run_start),
-                    reinterpret_cast<const uint8_t*>(s + i));
-            }
-
-            // Escape the special char
-            if (i < len) {
-                char c = s[i];
-                switch (c) {
-                    case '"':  buf_.push_back('\\'); buf_.push_back('"'); break;
-                    case '\\': buf_.push_back('\\'); buf_.push_back('\\'); break;
-                    case '\b': buf_.push_back('\\'); buf_.push_back('b'); break;
-                    case '\f': buf_.push_back('\\'); buf_.push_back('f'); break;
-                    case '\n': buf_.push_back('\\'); buf_.push_back('n'); break;
-                    case '\r': buf_.push_back('\\'); buf_.push_back('r'); break;
-                    case '\t': buf_.push_back('\\'); buf_.push_back('t'); break;
-                    default: {
-                        char hex[7];
-                        std::snprintf(hex, sizeof(hex), "\\u%04x", static_cast<unsigned char>(c));
-                        buf_.insert(buf_.end(), hex, hex + 6);
-                        break;
-                    }
-                }
-                ++i;
-            }
+    }
+
+    // Inline storage always has room for "{}", so this never allocates.
+    void clear() noexcept {
+        buf_.resize(0);
+        buf_.push_back('{');
+        buf_.push_back('}');
+        arrays_ = 0;
+        depth_ = 0;
+        ignored_ = 0;
+        count_ = 0;
+    }
+
+    Props& end_field() {
+        for (size_t d = depth_; d > 0; d--) buf_.push_back((arrays_ >> (d - 1) & 1) != 0 ? ']' : '}');
+        buf_.push_back('}');
+        return *this;
+    }
+
+    Props& open(std::string_view key, bool array) {
+        if (depth_ == MAX_DEPTH) {
+            ignored_++;
+            return *this;
+        }
+        begin_field(key);
+        buf_.push_back(array ? '[' : '{');
+        if (array) arrays_ |= uint64_t(1) << depth_;
+        depth_++;
+        return end_field();
+    }
+
+    Props& close(bool array) {
+        if (ignored_ > 0) {
+            ignored_--;
+        } else if (depth_ > 0 && in_array() == array) {
+            depth_--;
+            arrays_ &= ~(uint64_t(1) << depth_);
+        }
+        return *this;
+    }
+
+    template <typename It>
+    Props& add_array(std::string_view key, It first, It last) {
+        static_assert(!std::is_same<std::decay_t<decltype(*first)>, char>::value,
+                      "pass a char array as a string, not as an array of chars");
+        begin_field(key);
+        buf_.push_back('[');
+        for (It it = first; it != last; ++it) {
+            if (it != first) buf_.push_back(',');
+            write_value(*it);
         }
+        buf_.push_back(']');
+        return end_field();
+    }
+
+    void write_value(std::string_view value) { write_string(value.data(), value.size()); }
+    void write_value(const char* value) {
+        if (value == nullptr) return write_literal("null", 4);
+        write_string(value, std::strlen(value));
+    }
+    void write_value(int64_t value) { json::append_integer(buf_, value); }
+    void write_value(uint64_t value) { json::append_integer(buf_, value); }
+    void write_value(int value) { json::append_integer(buf_, value); }
+    void write_value(double value) { json::append_shortest(buf_, value); }
+    void write_value(float value) { json::append_shortest(buf_, value); }
+    void write_value(bool value) { write_literal(value ? "true" : "false", value ? 4 : 5); }
+
+    void write_string(const char* s, size_t len) {
+        buf_.push_back('"');
+        json::append_escaped(buf_, s, len);
+        buf_.push_back('"');
+    }
+
+    void write_literal(const char* s, size_t len) {
+        size_t at = buf_.size();
+        buf_.resize(at + len);
+        std::memcpy(buf_.data() + at, s, len);
     }
 };
 
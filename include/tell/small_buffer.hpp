@@ -0,0 +1,117 @@
+// include/tell/small_buffer.hpp
+// Byte buffer with inline storage — no heap allocation until it outgrows N.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace tell {
+namespace detail {
+
+// Growable byte buffer whose first N bytes live inline; past that it spills
+// to a heap vector. Offers the part of std::vector<uint8_t> the JSON writers
+// use (data, size, resize, push_back). Bytes added by a growing resize are
+// unspecified until written.
+template <size_t N>
+class SmallBuffer {
+public:
+    SmallBuffer() noexcept = default;
+
+    SmallBuffer(const SmallBuffer& other) { assign(other.data(), other.size_); }
+
+    SmallBuffer(SmallBuffer&& other) noexcept { take(other); }
+
+    SmallBuffer& operator=(const SmallBuffer& other) {
+        if (this != &other) {
+            size_ = 0;
+            assign(other.data(), other.size_);
+        }
+        return *this;
+    }
+
+    SmallBuffer& operator=(SmallBuffer&& other) noexcept {
+        if (this != &other) take(other);
+        return *this;
+    }
+
+    uint8_t* data() noexcept { return heap_.empty() ? inline_ : heap_.data(); }
+    const uint8_t* data() const noexcept { return heap_.empty() ? inline_ : heap_.data(); }
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return heap_.empty() ? N : heap_.size(); }
+    bool on_heap() const noexcept { return !heap_.empty(); }
+
+    void resize(size_t n) {
+        if (n > capacity()) grow(n);
+        size_ = n;
+    }
+
+    void reserve(size_t n) {
+        if (n > capacity()) grow(n);
+    }
+
+    void push_back(uint8_t byte) {
+        if (size_ == capacity()) grow(size_ + 1);
+        data()[size_++] = byte;
+    }
+
+    void pop_back() noexcept { size_--; }
+
+    // Hand the bytes over as a vector with room for at least `capacity`
+    // bytes: spilled storage moves out as is, inline bytes are copied. The
+    // buffer is left empty.
+    std::vector<uint8_t> release(size_t capacity = 0) {
+        std::vector<uint8_t> out;
+        if (on_heap()) {
+            out = std::move(heap_);
+            heap_.clear();
+            out.resize(size_);
+            if (out.capacity() < capacity) out.reserve(capacity);
+        } else {
+            out.reserve(capacity > size_ ? capacity : size_);
+            out.assign(inline_, inline_ + size_);
+        }
+        size_ = 0;
+        return out;
+    }
+
+private:
+    uint8_t inline_[N];
+    std::vector<uint8_t> heap_;  // empty until spilled; its size is the capacity
+    size_t size_ = 0;
+
+    // At least doubles, so appends stay amortized O(1) once on the heap.
+    void grow(size_t n) {
+        size_t cap = capacity() * 2;
+        if (cap < n) cap = n;
+        if (heap_.empty()) {
+            std::vector<uint8_t> heap(cap);
+            std::memcpy(heap.data(), inline_, size_);
+            heap_ = std::move(heap);
+        } else {
+            heap_.resize(cap);
+        }
+    }
+
+    void assign(const uint8_t* src, size_t n) {
+        resize(n);
+        if (n > 0) std::memcpy(data(), src, n);
+    }
+
+    void take(SmallBuffer& other) noexcept {
+        size_ = other.size_;
+        if (other.on_heap()) {
+            heap_ = std::move(other.heap_);
+            other.heap_.clear();
+        } else {
+            heap_ = std::vector<uint8_t>();
+            std::memcpy(inline_, other.inline_, size_);
+        }
+        other.size_ = 0;
+    }
+};
+
+} // namespace detail
+} // namespace tell
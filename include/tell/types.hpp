@@ -45,6 +45,12 @@ enum class LogLevel : uint8_t {
     Trace     = 8,
 };
 
+// Batch data compression codec — the Batch `compression` field.
+enum class Compression : uint8_t {
+    None = 0,
+    Lz4  = 1,  // LZ4 block, prefixed with its uncompressed length (u32 LE)
+};
+
 // Standard event names from the Tell specification (Appendix A).
 struct Events {
     // User Lifecycle
@@ -0,0 +1,72 @@
+// src/arena.hpp
+// Per-thread encoding arena — producer threads encode events in place.
+
+#pragma once
+
+#include "encoding.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tell {
+
+// Block of encoded bytes shared by every event written into it. The chunk
+// stays alive until the last event referencing it has been sent.
+struct ArenaChunk {
+    std::vector<uint8_t> bytes;
+};
+
+// One encoded event table inside an arena chunk.
+struct ArenaSlice {
+    std::shared_ptr<const ArenaChunk> chunk;
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+
+    explicit operator bool() const noexcept { return data != nullptr; }
+};
+
+// Thread-local bump arena for encode-on-producer mode.
+//
+// Each chunk's vector is reserved up front and never grows past its
+// capacity, so its storage never moves: slices handed to the worker stay
+// valid while this thread keeps appending behind them. The worker only
+// reads through ArenaSlice::data, never the vector itself.
+class ProducerArena {
+public:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    static ProducerArena& local() {
+        static thread_local ProducerArena arena;
+        return arena;
+    }
+
+    // Encode one event (standalone FlatBuffer) at a 4-aligned position.
+    ArenaSlice encode_event(const encoding::EventParams& params) {
+        size_t len = encoding::encoded_event_size(params);
+        // Aligned start may already be past capacity (a chunk ending off a
+        // 4-byte boundary), so compare sums rather than subtracting.
+        if (!chunk_ || aligned_size() + len > chunk_->bytes.capacity()) {
+            chunk_ = std::make_shared<ArenaChunk>();
+            chunk_->bytes.reserve(len > CHUNK_SIZE ? len : CHUNK_SIZE);
+        }
+
+        auto& bytes = chunk_->bytes;
+        encoding::align4(bytes);
+        size_t start = bytes.size();
+        encoding::encode_event_exact(bytes, params);
+
+        ArenaSlice slice;
+        slice.chunk = chunk_;
+        slice.data = bytes.data() + start;
+        slice.len = bytes.size() - start;
+        return slice;
+    }
+
+private:
+    size_t aligned_size() const { return (chunk_->bytes.size() + 3) & ~size_t(3); }
+
+    std::shared_ptr<ArenaChunk> chunk_;
+};
+
+} // namespace tell
@@ -6,12 +6,18 @@
 #include "worker.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstring>
+#include <functional>
+#include <future>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <shared_mutex>
+#include <string_view>
 
 namespace tell {
 
@@ -38,54 +44,37 @@ static uint64_t now_ms() {
     );
 }
 
+// Payload writers take std::vector<uint8_t> or the scratch SmallBuffer a
+// prefix is built in before it is spliced in front of owned props.
+
 // Append raw bytes from a string literal to a buffer.
-static inline void append_lit(std::vector<uint8_t>& buf, const char* s, size_t n) {
-    buf.insert(buf.end(), reinterpret_cast<const uint8_t*>(s),
-               reinterpret_cast<const uint8_t*>(s) + n);
+template <typename Buffer>
+static inline void append_lit(Buffer& buf, const char* s, size_t n) {
+    size_t at = buf.size();
+    buf.resize(at + n);
+    std::memcpy(buf.data() + at, s, n);
 }
 
-// Append a string value with JSON escaping (bulk-copy, matching Props::write_escaped).
-static inline bool needs_escape(char c) {
-    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+// Append a string value with JSON escaping (shared with Props::write_escaped).
+template <typename Buffer>
+static inline void append_escaped(Buffer& buf, std::string_view s) {
+    json::append_escaped(buf, s.data(), s.size());
 }
 
-static inline void append_escaped(std::vector<uint8_t>& buf, const std::string& s) {
-    size_t i = 0;
-    while (i < s.size()) {
-        size_t run_start = i;
-        while (i < s.size() && !needs_escape(s[i])) ++i;
-        if (i > run_start) {
-            buf.insert(buf.end(),
-                reinterpret_cast<const uint8_t*>(s.data() + run_start),
-                reinterpret_cast<const uint8_t*>(s.data() + i));
-        }
-        if (i < s.size()) {
-            char c = s[i];
-            switch (c) {
-                case '"':  buf.push_back('\\'); buf.push_back('"'); break;
-                case '\\': buf.push_back('\\'); buf.push_back('\\'); break;
-                case '\b': buf.push_back('\\'); buf.push_back('b'); break;
-                case '\f': buf.push_back('\\'); buf.push_back('f'); break;
-                case '\n': buf.push_back('\\'); buf.push_back('n'); break;
-                case '\r': buf.push_back('\\'); buf.push_back('r'); break;
-                case '\t': buf.push_back('\\'); buf.push_back('t'); break;
-                default: {
-                    char hex[7];
-                    std::snprintf(hex, sizeof(hex), "\\u%04x", static_cast<unsigned char>(c));
-                    buf.insert(buf.end(), hex, hex + 6);
-                    break;
-                }
-            }
-            ++i;
-        }
-    }
+// Append ",<super props>" when there are any.
+template <typename Buffer>
+static inline void append_super_props(Buffer& buf, const std::vector<uint8_t>& super_props_raw) {
+    if (super_props_raw.empty()) return;
+    buf.push_back(',');
+    append_lit(buf, reinterpret_cast<const char*>(super_props_raw.data()), super_props_raw.size());
 }
 
 // Parse Props raw bytes into a map, upserting entries.
-// Props raw format: "key1":value1,"key2":value2,...
+// Props raw format: "key1":value1,"key2":value2,... — a nested object or
+// array value is kept whole.
 static void parse_props_into_map(
-    const std::vector<uint8_t>& raw,
-    std::map<std::string, std::vector<uint8_t>>& map)
+    std::string_view raw,
+    std::map<std::string, std::vector<uint8_t>, std::less<>>& map)
 {
     size_t i = 0;
     size_t n = raw.size();
@@ -133,7 +122,25 @@ static void parse_props_into_map(
                 }
             }
         } else {
-            while (i < n && raw[i] != ',') i++;
+            // Number, literal, or a nested object/array: up to the next ','
+            // outside any nesting and strings.
+            int depth = 0;
+            bool in_string = false;
+            for (; i < n; i++) {
+                char c = raw[i];
+                if (in_string) {
+                    if (c == '\\') i++;
+                    else if (c == '"') in_string = false;
+                } else if (c == '"') {
+                    in_string = true;
+                } else if (c == '{' || c == '[') {
+                    depth++;
+                } else if (c == '}' || c == ']') {
+                    depth--;
+                } else if (c == ',' && depth == 0) {
+                    break;
+                }
+            }
         }
 
         map[std::move(key)] = std::vector<uint8_t>(
@@ -144,58 +151,104 @@ static void parse_props_into_map(
     }
 }
 
-// Build a JSON payload by merging key:value with optional super props and event props.
-// Super props come before event props so event-specific keys override (last-key-wins).
-static std::vector<uint8_t> merge_json_payload(
-    const char* key_colon, size_t key_colon_len,
-    const std::string& value,
-    const std::vector<uint8_t>* props_json = nullptr,
-    const std::vector<uint8_t>* super_props_raw = nullptr)
-{
-    const uint8_t* props_inner = nullptr;
-    size_t props_inner_len = 0;
-    if (props_json && props_json->size() > 2 && (*props_json)[0] == '{') {
-        props_inner = props_json->data() + 1;
-        props_inner_len = props_json->size() - 1;
-    }
-
-    std::vector<uint8_t> buf;
-    buf.reserve(2 + key_colon_len + value.size() + 2
-        + (super_props_raw ? super_props_raw->size() + 1 : 0)
-        + (props_inner ? props_inner_len + 1 : 0));
-
-    buf.push_back('{');
-    append_lit(buf, key_colon, key_colon_len);
-
-    buf.push_back('"');
-    append_escaped(buf, value);
-    buf.push_back('"');
+// Props fields plus the closing brace ("k":v,...}), read in place; empty
+// when there are none.
+static std::string_view props_tail(const Props& props) {
+    return props.empty() ? std::string_view() : props.json().substr(1);
+}
 
-    if (super_props_raw && !super_props_raw->empty()) {
-        buf.push_back(',');
-        buf.insert(buf.end(), super_props_raw->begin(), super_props_raw->end());
+// Append ",<props tail>" or, without props, just the closing brace.
+static inline void append_props_tail(std::vector<uint8_t>& buf, std::string_view tail) {
+    if (tail.empty()) {
+        buf.push_back('}');
+        return;
     }
+    buf.push_back(',');
+    append_lit(buf, tail.data(), tail.size());
+}
 
-    if (props_inner) {
-        buf.push_back(',');
-        buf.insert(buf.end(), props_inner, props_inner + props_inner_len);
-    } else {
-        buf.push_back('}');
+// Build "{<prefix>,<props fields>}", or "{<prefix>}" without props, where
+// write_prefix(buf) appends the leading fields (user_id, super props...).
+// Super props go in the prefix, before event props, so event-specific keys
+// override them (last-key-wins).
+//
+// Borrowed props are copied in after the prefix. Owned props (Props&&) that
+// have spilled to the heap keep their buffer: the prefix is built in a
+// scratch buffer and inserted after their '{', moving the fields up in
+// place, so a large property set is never copied into a second buffer.
+// Inline owned props would be copied out anyway and take the borrowed path.
+template <typename WritePrefix>
+static std::vector<uint8_t> build_payload(const Props& props, Props* owned, size_t prefix_hint,
+                                          WritePrefix&& write_prefix) {
+    if (owned != nullptr && owned->json().size() > Props::INLINE_BYTES) {
+        detail::SmallBuffer<Props::INLINE_BYTES> prefix;
+        prefix.reserve(prefix_hint + 1);
+        write_prefix(prefix);
+        prefix.push_back(',');
+        size_t size = owned->json().size() + prefix.size();
+        auto buf = std::move(*owned).take_json_bytes(size);
+        buf.insert(buf.begin() + 1, prefix.data(), prefix.data() + prefix.size());
+        return buf;
     }
 
+    auto tail = props_tail(props);
+    std::vector<uint8_t> buf;
+    buf.reserve(1 + prefix_hint + 1 + tail.size());
+    buf.push_back('{');
+    write_prefix(buf);
+    append_props_tail(buf, tail);
+    if (owned != nullptr) *owned = Props();
     return buf;
 }
 
 // ---
 
+// Joins per-shard flush results; the last shard to answer fires the callback
+// with the merged result (counts summed, worst outcome wins).
+struct FlushJoin {
+    std::mutex mutex;
+    size_t remaining;
+    FlushResult merged;
+    FlushCallback callback;
+
+    FlushJoin(size_t shards, FlushCallback cb) : remaining(shards), callback(std::move(cb)) {}
+
+    void complete(const FlushResult& r) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            merged.events += r.events;
+            merged.logs += r.logs;
+            merged.dropped += r.dropped;
+            if (static_cast<uint8_t>(r.outcome) > static_cast<uint8_t>(merged.outcome)) {
+                merged.outcome = r.outcome;
+            }
+            if (--remaining > 0) return;
+        }
+        if (callback) callback(merged);
+    }
+};
+
+// Super props as written into payloads ("k1":v1,"k2":v2, keys escaped),
+// immutable once published.
+struct SuperPropsSnapshot {
+    uint64_t version = 0;
+    std::vector<uint8_t> raw;
+};
+
 struct Tell::Inner {
     uint8_t device_id[16] = {};
     mutable std::shared_mutex session_mutex;
     uint8_t session_id[16] = {};
-    mutable std::shared_mutex super_props_mutex;
-    std::map<std::string, std::vector<uint8_t>> super_props_map;
+    // Writers (register_props/unregister) edit the map under the mutex and
+    // publish a fresh snapshot; events only ever read the snapshot.
+    std::mutex super_props_mutex;
+    std::map<std::string, std::vector<uint8_t>, std::less<>> super_props_map;  // guarded by super_props_mutex
+    std::shared_ptr<const SuperPropsSnapshot> super_props;  // std::atomic_load/atomic_store only
+    std::atomic<uint64_t> super_props_version{0};            // super_props->version
     TellConfig::ErrorCallback on_error;
-    std::unique_ptr<Worker> worker;
+    // One worker per shard; events route by user_id, logs round-robin.
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> next_log_shard{0};
     std::chrono::milliseconds close_timeout;
 
     void report_error(TellError err) const {
@@ -204,26 +257,74 @@ struct Tell::Inner {
         }
     }
 
+    // Same user always lands on the same shard, keeping per-user order.
+    Worker& event_worker(std::string_view user_id) const {
+        if (workers.size() == 1) return *workers[0];
+        return *workers[std::hash<std::string_view>{}(user_id) % workers.size()];
+    }
+
+    Worker& log_worker() {
+        if (workers.size() == 1) return *workers[0];
+        return *workers[next_log_shard.fetch_add(1, std::memory_order_relaxed) % workers.size()];
+    }
+
+    // Send a flush or close signal to every shard; callback fires once all
+    // of them have answered.
+    void fan_out(bool close, FlushCallback callback) {
+        auto join = std::make_shared<FlushJoin>(workers.size(), std::move(callback));
+        for (auto& w : workers) {
+            auto done = [join](const FlushResult& r) { join->complete(r); };
+            if (close) {
+                w->send_close(std::move(done));
+            } else {
+                w->send_flush(std::move(done));
+            }
+        }
+    }
+
+    std::future<FlushResult> fan_out(bool close) {
+        auto promise = std::make_shared<std::promise<FlushResult>>();
+        auto future = promise->get_future();
+        fan_out(close, [promise](const FlushResult& r) { promise->set_value(r); });
+        return future;
+    }
+
     void read_session_id(uint8_t out[16]) const {
         std::shared_lock<std::shared_mutex> lock(session_mutex);
         std::memcpy(out, session_id, 16);
     }
 
-    std::vector<uint8_t> read_super_props() const {
-        std::shared_lock<std::shared_mutex> lock(super_props_mutex);
-        if (super_props_map.empty()) return {};
-        std::vector<uint8_t> result;
-        bool first = true;
+    // The current snapshot, without a lock or a reference count in the
+    // common case: each thread keeps the last snapshot it loaded and only
+    // reloads when the published version has moved on. Versions are unique
+    // across clients, so one cache serves every client on the thread. The
+    // reference is good until this thread's next call.
+    const SuperPropsSnapshot& super_props_snapshot() const {
+        thread_local std::shared_ptr<const SuperPropsSnapshot> cached;
+        if (!cached || cached->version != super_props_version.load(std::memory_order_acquire)) {
+            cached = std::atomic_load(&super_props);
+        }
+        return *cached;
+    }
+
+    // Serialize the map into a new snapshot and publish it. Caller holds
+    // super_props_mutex.
+    void publish_super_props() {
+        static std::atomic<uint64_t> next_version{1};
+        auto snapshot = std::make_shared<SuperPropsSnapshot>();
+        snapshot->version = next_version.fetch_add(1, std::memory_order_relaxed);
+        auto& raw = snapshot->raw;
         for (const auto& [key, value] : super_props_map) {
-            if (!first) result.push_back(',');
-            first = false;
-            result.push_back('"');
-            append_escaped(result, key);
-            result.push_back('"');
-            result.push_back(':');
-            result.insert(result.end(), value.begin(), value.end());
+            if (!raw.empty()) raw.push_back(',');
+            raw.push_back('"');
+            append_escaped(raw, key);
+            raw.push_back('"');
+            raw.push_back(':');
+            raw.insert(raw.end(), value.begin(), value.end());
         }
-        return result;
+        uint64_t version = snapshot->version;
+        std::atomic_store(&super_props, std::shared_ptr<const SuperPropsSnapshot>(std::move(snapshot)));
+        super_props_version.store(version, std::memory_order_release);
     }
 };
 
@@ -232,7 +333,12 @@ Tell::Tell(TellConfig config) : inner_(std::make_unique<Inner>()) {
     generate_uuid(inner_->session_id);
     inner_->on_error = config.on_error();
     inner_->close_timeout = config.close_timeout();
-    inner_->worker = std::make_unique<Worker>(std::move(config));
+    inner_->publish_super_props();
+    size_t shards = config.workers();
+    inner_->workers.reserve(shards);
+    for (size_t i = 0; i < shards; i++) {
+        inner_->workers.push_back(std::make_unique<Worker>(config, i, shards));
+    }
 }
 
 Tell::~Tell() = default;
@@ -245,8 +351,17 @@ std::unique_ptr<Tell> Tell::create(TellConfig config) {
 
 // --- Events ---
 
-void Tell::track(const std::string& user_id, const std::string& event_name,
+void Tell::track(std::string_view user_id, std::string_view event_name,
                  const Props& properties) {
+    send_track(user_id, event_name, properties, nullptr);
+}
+
+void Tell::track(std::string_view user_id, std::string_view event_name, Props&& properties) {
+    send_track(user_id, event_name, properties, &properties);
+}
+
+void Tell::send_track(std::string_view user_id, std::string_view event_name,
+                      const Props& properties, Props* owned) {
     if (!validation::check_user_id(user_id)) {
         inner_->report_error(TellError::validation("userId", "is required"));
         return;
@@ -257,39 +372,62 @@ void Tell::track(const std::string& user_id, const std::string& event_name,
         return;
     }
 
-    auto props_json = properties.empty() ? std::vector<uint8_t>{} : properties.to_json_bytes();
-    auto sp_raw = inner_->read_super_props();
-    auto payload = merge_json_payload("\"user_id\":", 10, user_id,
-                                       props_json.empty() ? nullptr : &props_json,
-                                       sp_raw.empty() ? nullptr : &sp_raw);
+    const auto& sp_raw = inner_->super_props_snapshot().raw;
+    auto payload = build_payload(properties, owned, 14 + user_id.size() + sp_raw.size(),
+        [&](auto& buf) {
+            append_lit(buf, "\"user_id\":\"", 11);
+            append_escaped(buf, user_id);
+            buf.push_back('"');
+            append_super_props(buf, sp_raw);
+        });
 
     QueuedEvent event;
     event.event_type = EventType::Track;
     event.timestamp = now_ms();
     std::memcpy(event.device_id, inner_->device_id, 16);
     inner_->read_session_id(event.session_id);
-    event.event_name = event_name;
+    event.event_name.assign(event_name.data(), event_name.size());
     event.payload = std::move(payload);
 
-    inner_->worker->send_event(std::move(event));
+    inner_->event_worker(user_id).send_event(std::move(event));
+}
+
+void Tell::identify(std::string_view user_id, const Props& traits) {
+    send_identify(user_id, traits, nullptr);
+}
+
+void Tell::identify(std::string_view user_id, Props&& traits) {
+    send_identify(user_id, traits, &traits);
 }
 
-void Tell::identify(const std::string& user_id, const Props& traits) {
+void Tell::send_identify(std::string_view user_id, const Props& traits, Props* owned) {
     if (!validation::check_user_id(user_id)) {
         inner_->report_error(TellError::validation("userId", "is required"));
         return;
     }
 
-    std::vector<uint8_t> buf;
-    buf.reserve(64 + user_id.size());
-    append_lit(buf, "{\"user_id\":\"", 12);
-    append_escaped(buf, user_id);
-    buf.push_back('"');
+    // Traits nest as a whole object: {"user_id":"...","traits":{...}}
+    auto write_prefix = [&](auto& buf) {
+        append_lit(buf, "{\"user_id\":\"", 12);
+        append_escaped(buf, user_id);
+        buf.push_back('"');
+        if (!traits.empty()) append_lit(buf, ",\"traits\":", 10);
+    };
 
-    if (!traits.empty()) {
-        append_lit(buf, ",\"traits\":", 10);
-        auto traits_json = traits.to_json_bytes();
-        buf.insert(buf.end(), traits_json.begin(), traits_json.end());
+    std::vector<uint8_t> buf;
+    if (owned != nullptr && owned->json().size() > Props::INLINE_BYTES) {
+        detail::SmallBuffer<Props::INLINE_BYTES> prefix;
+        write_prefix(prefix);
+        buf = std::move(*owned).take_json_bytes(owned->json().size() + prefix.size() + 1);
+        buf.insert(buf.begin(), prefix.data(), prefix.data() + prefix.size());
+    } else {
+        buf.reserve(64 + user_id.size() + (traits.empty() ? 0 : traits.json().size()));
+        write_prefix(buf);
+        if (!traits.empty()) {
+            auto traits_json = traits.json();
+            append_lit(buf, traits_json.data(), traits_json.size());
+        }
+        if (owned != nullptr) *owned = Props();
     }
     buf.push_back('}');
 
@@ -300,11 +438,20 @@ void Tell::identify(const std::string& user_id, const Props& traits) {
     inner_->read_session_id(event.session_id);
     event.payload = std::move(buf);
 
-    inner_->worker->send_event(std::move(event));
+    inner_->event_worker(user_id).send_event(std::move(event));
 }
 
-void Tell::group(const std::string& user_id, const std::string& group_id,
+void Tell::group(std::string_view user_id, std::string_view group_id,
                  const Props& properties) {
+    send_group(user_id, group_id, properties, nullptr);
+}
+
+void Tell::group(std::string_view user_id, std::string_view group_id, Props&& properties) {
+    send_group(user_id, group_id, properties, &properties);
+}
+
+void Tell::send_group(std::string_view user_id, std::string_view group_id,
+                      const Props& properties, Props* owned) {
     if (!validation::check_user_id(user_id)) {
         inner_->report_error(TellError::validation("userId", "is required"));
         return;
@@ -314,51 +461,49 @@ void Tell::group(const std::string& user_id, const std::string& group_id,
         return;
     }
 
-    auto props_json = properties.empty() ? std::vector<uint8_t>{} : properties.to_json_bytes();
-    auto sp_raw = inner_->read_super_props();
+    const auto& sp_raw = inner_->super_props_snapshot().raw;
+    auto payload = build_payload(properties, owned, 80 + user_id.size() + group_id.size() + sp_raw.size(),
+        [&](auto& buf) {
+            append_lit(buf, "\"group_id\":\"", 12);
+            append_escaped(buf, group_id);
+            buf.push_back('"');
 
-    std::vector<uint8_t> buf;
-    buf.reserve(80 + user_id.size() + group_id.size() + sp_raw.size() + props_json.size());
-    buf.push_back('{');
+            append_lit(buf, ",\"user_id\":\"", 12);
+            append_escaped(buf, user_id);
+            buf.push_back('"');
 
-    append_lit(buf, "\"group_id\":\"", 12);
-    append_escaped(buf, group_id);
-    buf.push_back('"');
-
-    append_lit(buf, ",\"user_id\":\"", 12);
-    append_escaped(buf, user_id);
-    buf.push_back('"');
-
-    if (!sp_raw.empty()) {
-        buf.push_back(',');
-        buf.insert(buf.end(), sp_raw.begin(), sp_raw.end());
-    }
-
-    if (!props_json.empty() && props_json.size() > 2 && props_json[0] == '{') {
-        buf.push_back(',');
-        buf.insert(buf.end(), props_json.begin() + 1, props_json.end());
-    } else {
-        buf.push_back('}');
-    }
+            append_super_props(buf, sp_raw);
+        });
 
     QueuedEvent event;
     event.event_type = EventType::Group;
     event.timestamp = now_ms();
     std::memcpy(event.device_id, inner_->device_id, 16);
     inner_->read_session_id(event.session_id);
-    event.payload = std::move(buf);
+    event.payload = std::move(payload);
 
-    inner_->worker->send_event(std::move(event));
+    inner_->event_worker(user_id).send_event(std::move(event));
 }
 
-void Tell::revenue(const std::string& user_id, double amount,
-                   const std::string& currency, const std::string& order_id,
+void Tell::revenue(std::string_view user_id, double amount,
+                   std::string_view currency, std::string_view order_id,
                    const Props& properties) {
+    send_revenue(user_id, amount, currency, order_id, properties, nullptr);
+}
+
+void Tell::revenue(std::string_view user_id, double amount,
+                   std::string_view currency, std::string_view order_id,
+                   Props&& properties) {
+    send_revenue(user_id, amount, currency, order_id, properties, &properties);
+}
+
+void Tell::send_revenue(std::string_view user_id, double amount, std::string_view currency,
+                        std::string_view order_id, const Props& properties, Props* owned) {
     if (!validation::check_user_id(user_id)) {
         inner_->report_error(TellError::validation("userId", "is required"));
         return;
     }
-    if (amount <= 0.0) {
+    if (!std::isfinite(amount) || amount <= 0.0) {
         inner_->report_error(TellError::validation("amount", "must be positive"));
         return;
     }
@@ -371,43 +516,26 @@ void Tell::revenue(const std::string& user_id, double amount,
         return;
     }
 
-    auto props_json = properties.empty() ? std::vector<uint8_t>{} : properties.to_json_bytes();
-    auto sp_raw = inner_->read_super_props();
+    const auto& sp_raw = inner_->super_props_snapshot().raw;
+    size_t prefix_hint = 120 + user_id.size() + currency.size() + order_id.size() + sp_raw.size();
+    auto payload = build_payload(properties, owned, prefix_hint, [&](auto& buf) {
+        append_lit(buf, "\"user_id\":\"", 11);
+        append_escaped(buf, user_id);
+        buf.push_back('"');
 
-    char amount_str[64];
-    int amount_len = std::snprintf(amount_str, sizeof(amount_str), "%g", amount);
+        append_lit(buf, ",\"amount\":", 10);
+        json::append_shortest(buf, amount);
 
-    std::vector<uint8_t> buf;
-    buf.reserve(120 + user_id.size() + currency.size() + order_id.size()
-                + sp_raw.size() + props_json.size());
-    buf.push_back('{');
-
-    append_lit(buf, "\"user_id\":\"", 11);
-    append_escaped(buf, user_id);
-    buf.push_back('"');
-
-    append_lit(buf, ",\"amount\":", 10);
-    if (amount_len > 0) buf.insert(buf.end(), amount_str, amount_str + amount_len);
-
-    append_lit(buf, ",\"currency\":\"", 13);
-    append_escaped(buf, currency);
-    buf.push_back('"');
-
-    append_lit(buf, ",\"order_id\":\"", 13);
-    append_escaped(buf, order_id);
-    buf.push_back('"');
+        append_lit(buf, ",\"currency\":\"", 13);
+        append_escaped(buf, currency);
+        buf.push_back('"');
 
-    if (!sp_raw.empty()) {
-        buf.push_back(',');
-        buf.insert(buf.end(), sp_raw.begin(), sp_raw.end());
-    }
+        append_lit(buf, ",\"order_id\":\"", 13);
+        append_escaped(buf, order_id);
+        buf.push_back('"');
 
-    if (!props_json.empty() && props_json.size() > 2 && props_json[0] == '{') {
-        buf.push_back(',');
-        buf.insert(buf.end(), props_json.begin() + 1, props_json.end());
-    } else {
-        buf.push_back('}');
-    }
+        append_super_props(buf, sp_raw);
+    });
 
     QueuedEvent event;
     event.event_type = EventType::Track;
@@ -415,12 +543,12 @@ void Tell::revenue(const std::string& user_id, double amount,
     std::memcpy(event.device_id, inner_->device_id, 16);
     inner_->read_session_id(event.session_id);
     event.event_name = "Order Completed";
-    event.payload = std::move(buf);
+    event.payload = std::move(payload);
 
-    inner_->worker->send_event(std::move(event));
+    inner_->event_worker(user_id).send_event(std::move(event));
 }
 
-void Tell::alias(const std::string& previous_id, const std::string& user_id) {
+void Tell::alias(std::string_view previous_id, std::string_view user_id) {
     if (previous_id.empty()) {
         inner_->report_error(TellError::validation("previousId", "is required"));
         return;
@@ -446,13 +574,22 @@ void Tell::alias(const std::string& previous_id, const std::string& user_id) {
     inner_->read_session_id(event.session_id);
     event.payload = std::move(buf);
 
-    inner_->worker->send_event(std::move(event));
+    inner_->event_worker(user_id).send_event(std::move(event));
 }
 
 // --- Logging ---
 
-void Tell::log(LogLevel level, const std::string& message,
-               const std::string& service, const Props& data) {
+void Tell::log(LogLevel level, std::string_view message,
+               std::string_view service, const Props& data) {
+    send_log(level, message, service, data, nullptr);
+}
+
+void Tell::log(LogLevel level, std::string_view message, std::string_view service, Props&& data) {
+    send_log(level, message, service, data, &data);
+}
+
+void Tell::send_log(LogLevel level, std::string_view message, std::string_view service,
+                    const Props& data, Props* owned) {
     if (!validation::check_log_message(message)) {
         inner_->report_error(TellError::validation("message",
             message.empty() ? "is required" : "must be at most 65536 characters"));
@@ -463,47 +600,63 @@ void Tell::log(LogLevel level, const std::string& message,
         return;
     }
 
-    auto data_json = data.empty() ? std::vector<uint8_t>{} : data.to_json_bytes();
-    auto payload = merge_json_payload("\"message\":", 10, message,
-                                       data_json.empty() ? nullptr : &data_json);
+    auto payload = build_payload(data, owned, 14 + message.size(), [&](auto& buf) {
+        append_lit(buf, "\"message\":\"", 11);
+        append_escaped(buf, message);
+        buf.push_back('"');
+    });
 
     // Resolve service: explicit param > config-level > "app"
-    const auto& config_svc = inner_->worker->config().service();
-    const std::string& resolved_service = !service.empty() ? service
-        : !config_svc.empty() ? config_svc
-        : ([]() -> const std::string& { static const std::string def = "app"; return def; })();
+    const auto& config_svc = inner_->workers[0]->config().service();
+    std::string_view resolved_service = !service.empty() ? service
+        : !config_svc.empty() ? std::string_view(config_svc)
+        : std::string_view("app");
 
     QueuedLog entry;
     entry.level = level;
     entry.timestamp = now_ms();
     inner_->read_session_id(entry.session_id);
-    entry.service = resolved_service;
+    entry.service.assign(resolved_service.data(), resolved_service.size());
     entry.payload = std::move(payload);
 
-    inner_->worker->send_log(std::move(entry));
+    inner_->log_worker().send_log(std::move(entry));
 }
 
-void Tell::log_emergency(const std::string& m, const std::string& s, const Props& d) { log(LogLevel::Emergency, m, s, d); }
-void Tell::log_alert(const std::string& m, const std::string& s, const Props& d)     { log(LogLevel::Alert, m, s, d); }
-void Tell::log_critical(const std::string& m, const std::string& s, const Props& d)  { log(LogLevel::Critical, m, s, d); }
-void Tell::log_error(const std::string& m, const std::string& s, const Props& d)     { log(LogLevel::Error, m, s, d); }
-void Tell::log_warning(const std::string& m, const std::string& s, const Props& d)   { log(LogLevel::Warning, m, s, d); }
-void Tell::log_notice(const std::string& m, const std::string& s, const Props& d)    { log(LogLevel::Notice, m, s, d); }
-void Tell::log_info(const std::string& m, const std::string& s, const Props& d)      { log(LogLevel::Info, m, s, d); }
-void Tell::log_debug(const std::string& m, const std::string& s, const Props& d)     { log(LogLevel::Debug, m, s, d); }
-void Tell::log_trace(const std::string& m, const std::string& s, const Props& d)     { log(LogLevel::Trace, m, s, d); }
+void Tell::log_emergency(std::string_view m, std::string_view s, const Props& d) { log(LogLevel::Emergency, m, s, d); }
+void Tell::log_alert(std::string_view m, std::string_view s, const Props& d)     { log(LogLevel::Alert, m, s, d); }
+void Tell::log_critical(std::string_view m, std::string_view s, const Props& d)  { log(LogLevel::Critical, m, s, d); }
+void Tell::log_error(std::string_view m, std::string_view s, const Props& d)     { log(LogLevel::Error, m, s, d); }
+void Tell::log_warning(std::string_view m, std::string_view s, const Props& d)   { log(LogLevel::Warning, m, s, d); }
+void Tell::log_notice(std::string_view m, std::string_view s, const Props& d)    { log(LogLevel::Notice, m, s, d); }
+void Tell::log_info(std::string_view m, std::string_view s, const Props& d)      { log(LogLevel::Info, m, s, d); }
+void Tell::log_debug(std::string_view m, std::string_view s, const Props& d)     { log(LogLevel::Debug, m, s, d); }
+void Tell::log_trace(std::string_view m, std::string_view s, const Props& d)     { log(LogLevel::Trace, m, s, d); }
+
+void Tell::log_emergency(std::string_view m, std::string_view s, Props&& d) { log(LogLevel::Emergency, m, s, std::move(d)); }
+void Tell::log_alert(std::string_view m, std::string_view s, Props&& d)     { log(LogLevel::Alert, m, s, std::move(d)); }
+void Tell::log_critical(std::string_view m, std::string_view s, Props&& d)  { log(LogLevel::Critical, m, s, std::move(d)); }
+void Tell::log_error(std::string_view m, std::string_view s, Props&& d)     { log(LogLevel::Error, m, s, std::move(d)); }
+void Tell::log_warning(std::string_view m, std::string_view s, Props&& d)   { log(LogLevel::Warning, m, s, std::move(d)); }
+void Tell::log_notice(std::string_view m, std::string_view s, Props&& d)    { log(LogLevel::Notice, m, s, std::move(d)); }
+void Tell::log_info(std::string_view m, std::string_view s, Props&& d)      { log(LogLevel::Info, m, s, std::move(d)); }
+void Tell::log_debug(std::string_view m, std::string_view s, Props&& d)     { log(LogLevel::Debug, m, s, std::move(d)); }
+void Tell::log_trace(std::string_view m, std::string_view s, Props&& d)     { log(LogLevel::Trace, m, s, std::move(d)); }
 
 // --- Super Properties ---
 
 void Tell::register_props(const Props& properties) {
     if (properties.empty()) return;
-    std::unique_lock<std::shared_mutex> lock(inner_->super_props_mutex);
+    std::lock_guard<std::mutex> lock(inner_->super_props_mutex);
     parse_props_into_map(properties.raw(), inner_->super_props_map);
+    inner_->publish_super_props();
 }
 
-void Tell::unregister(const std::string& key) {
-    std::unique_lock<std::shared_mutex> lock(inner_->super_props_mutex);
-    inner_->super_props_map.erase(key);
+void Tell::unregister(std::string_view key) {
+    std::lock_guard<std::mutex> lock(inner_->super_props_mutex);
+    auto it = inner_->super_props_map.find(key);
+    if (it == inner_->super_props_map.end()) return;
+    inner_->super_props_map.erase(it);
+    inner_->publish_super_props();
 }
 
 // --- Session ---
@@ -516,13 +669,27 @@ void Tell::reset_session() {
 // --- Lifecycle ---
 
 void Tell::flush() {
-    auto f = inner_->worker->send_flush();
-    f.wait_for(inner_->close_timeout);
+    flush_async().wait_for(inner_->close_timeout);
 }
 
 void Tell::close() {
-    auto f = inner_->worker->send_close();
-    f.wait_for(inner_->close_timeout);
+    close_async().wait_for(inner_->close_timeout);
+}
+
+std::future<FlushResult> Tell::flush_async() {
+    return inner_->fan_out(false);
+}
+
+void Tell::flush_async(FlushCallback callback) {
+    inner_->fan_out(false, std::move(callback));
+}
+
+std::future<FlushResult> Tell::close_async() {
+    return inner_->fan_out(true);
+}
+
+void Tell::close_async(FlushCallback callback) {
+    inner_->fan_out(true, std::move(callback));
 }
 
 } // namespace tell
@@ -64,6 +64,86 @@ TellConfigBuilder& TellConfigBuilder::network_timeout(std::chrono::milliseconds
     return *this;
 }
 
+TellConfigBuilder& TellConfigBuilder::staging_block_size(size_t size) {
+    config_.staging_block_size_ = size;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::queue_policy(QueuePolicy policy) {
+    config_.queue_policy_ = policy;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::queue_capacity(size_t messages) {
+    config_.queue_capacity_ = messages;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::queue_max_bytes(size_t bytes) {
+    config_.queue_max_bytes_ = bytes;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::queue_block_timeout(std::chrono::milliseconds timeout) {
+    config_.queue_block_timeout_ = timeout;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::encode_on_producer(bool enabled) {
+    config_.encode_on_producer_ = enabled;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::workers(size_t count) {
+    config_.workers_ = count;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::priority_log_level(LogLevel level) {
+    config_.priority_log_level_ = level;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::bulk_log_level(LogLevel level) {
+    config_.bulk_log_level_ = level;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::max_batch_bytes(size_t bytes) {
+    config_.max_batch_bytes_ = bytes;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::max_frame_bytes(size_t bytes) {
+    config_.max_frame_bytes_ = bytes;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::adaptive_linger(bool enabled) {
+    config_.adaptive_linger_ = enabled;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::max_latency(std::chrono::milliseconds latency) {
+    config_.max_latency_ = latency;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::min_batch_size(size_t size) {
+    config_.min_batch_size_ = size;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::compression(Compression codec) {
+    config_.compression_ = codec;
+    return *this;
+}
+
+TellConfigBuilder& TellConfigBuilder::compression_min_bytes(size_t bytes) {
+    config_.compression_min_bytes_ = bytes;
+    return *this;
+}
+
 TellConfigBuilder& TellConfigBuilder::on_error(TellConfig::ErrorCallback callback) {
     config_.on_error_ = std::move(callback);
     return *this;
@@ -72,6 +152,23 @@ TellConfigBuilder& TellConfigBuilder::on_error(TellConfig::ErrorCallback callbac
 TellConfig TellConfigBuilder::build() const {
     TellConfig result = config_;
     result.api_key_bytes_ = validation::validate_and_decode_api_key(api_key_);
+    if (result.queue_capacity_ == 0) {
+        throw TellError::configuration("queue_capacity must be at least 1");
+    }
+    if (result.workers_ == 0) {
+        throw TellError::configuration("workers must be at least 1");
+    }
+    // Lower value = more severe
+    if (result.priority_log_level_ >= result.bulk_log_level_) {
+        throw TellError::configuration("priority_log_level must be more severe than bulk_log_level");
+    }
+    if (result.max_frame_bytes_ > 0 && result.max_batch_bytes_ > result.max_frame_bytes_) {
+        throw TellError::configuration("max_batch_bytes must not exceed max_frame_bytes");
+    }
+    if (result.adaptive_linger_ &&
+        (result.min_batch_size_ == 0 || result.min_batch_size_ > result.batch_size_)) {
+        throw TellError::configuration("min_batch_size must be between 1 and batch_size");
+    }
     return result;
 }
 
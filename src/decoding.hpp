@@ -0,0 +1,386 @@
+// src/decoding.hpp
+// Zero-copy FlatBuffer decoding — read-only views over Batch, EventData and
+// LogData frames, plus a bounds-checking verifier.
+//
+// Views read fields in place through the vtable: no copies, no allocation,
+// no checks. Run a Verifier over any frame that did not come straight from
+// the encoders before viewing it; once it passes, every accessor below stays
+// in bounds. Absent scalars read as 0; absent strings and vectors have a null
+// data pointer. Like the encoders, this assumes a little-endian host.
+
+#pragma once
+
+#include "encoding.hpp"
+#include "lz4.hpp"
+#include "tell/types.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+namespace tell {
+namespace decoding {
+
+namespace detail {
+
+template <typename T>
+T load(const uint8_t* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+} // namespace detail
+
+// Byte vector inside a frame; data is nullptr when the field is absent.
+struct Bytes {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const noexcept { return data != nullptr; }
+    std::string_view str() const { return {reinterpret_cast<const char*>(data), size}; }
+};
+
+// Any table: the vtable lookup shared by the typed views.
+class TableView {
+public:
+    TableView() = default;
+    explicit TableView(const uint8_t* table) : table_(table) {}
+
+    const uint8_t* position() const noexcept { return table_; }
+
+    // Field position, or nullptr when the vtable leaves it out
+    const uint8_t* field(uint8_t slot) const {
+        const uint8_t* vtable = table_ - detail::load<int32_t>(table_);
+        size_t entry = 4 + 2 * static_cast<size_t>(slot);
+        if (entry >= detail::load<uint16_t>(vtable)) return nullptr;
+        uint16_t offset = detail::load<uint16_t>(vtable + entry);
+        return offset != 0 ? table_ + offset : nullptr;
+    }
+
+    template <typename T>
+    T scalar(uint8_t slot) const {
+        const uint8_t* p = field(slot);
+        return p ? detail::load<T>(p) : T{};
+    }
+
+    // Target of an offset field, or nullptr
+    const uint8_t* target(uint8_t slot) const {
+        const uint8_t* p = field(slot);
+        return p ? p + detail::load<uint32_t>(p) : nullptr;
+    }
+
+    Bytes bytes(uint8_t slot) const {
+        const uint8_t* vec = target(slot);
+        return vec ? Bytes{vec + 4, detail::load<uint32_t>(vec)} : Bytes{};
+    }
+
+    std::string_view string(uint8_t slot) const {
+        Bytes b = bytes(slot);
+        return b ? b.str() : std::string_view();
+    }
+
+protected:
+    const uint8_t* table_ = nullptr;
+};
+
+// Vector of tables, viewed as View.
+template <typename View>
+class TableVector {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = View;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = View;
+
+        explicit iterator(const uint8_t* slot) : slot_(slot) {}
+        View operator*() const { return View(slot_ + detail::load<uint32_t>(slot_)); }
+        iterator& operator++() { slot_ += 4; return *this; }
+        iterator operator++(int) { iterator old = *this; slot_ += 4; return old; }
+        bool operator==(const iterator& o) const { return slot_ == o.slot_; }
+        bool operator!=(const iterator& o) const { return slot_ != o.slot_; }
+
+    private:
+        const uint8_t* slot_;
+    };
+
+    TableVector() = default;
+    explicit TableVector(const uint8_t* vec) : vec_(vec) {}
+
+    size_t size() const { return vec_ ? detail::load<uint32_t>(vec_) : 0; }
+    bool empty() const { return size() == 0; }
+    View operator[](size_t i) const { return *iterator(vec_ + 4 + 4 * i); }
+    iterator begin() const { return iterator(vec_ ? vec_ + 4 : nullptr); }
+    iterator end() const { return iterator(vec_ ? vec_ + 4 + 4 * size() : nullptr); }
+
+private:
+    const uint8_t* vec_ = nullptr;
+};
+
+class EventView : public TableView {
+public:
+    using TableView::TableView;
+
+    EventType event_type() const { return static_cast<EventType>(scalar<uint8_t>(F::event_type)); }
+    uint64_t timestamp() const { return scalar<uint64_t>(F::timestamp); }
+    std::string_view service() const { return string(F::service); }
+    Bytes device_id() const { return bytes(F::device_id); }
+    Bytes session_id() const { return bytes(F::session_id); }
+    std::string_view event_name() const { return string(F::event_name); }
+    Bytes payload() const { return bytes(F::payload); }
+
+private:
+    using F = encoding::schema::event::Slot;
+};
+
+class LogEntryView : public TableView {
+public:
+    using TableView::TableView;
+
+    LogEventType event_type() const { return static_cast<LogEventType>(scalar<uint8_t>(F::event_type)); }
+    Bytes session_id() const { return bytes(F::session_id); }
+    LogLevel level() const { return static_cast<LogLevel>(scalar<uint8_t>(F::level)); }
+    uint64_t timestamp() const { return scalar<uint64_t>(F::timestamp); }
+    std::string_view source() const { return string(F::source); }
+    std::string_view service() const { return string(F::service); }
+    Bytes payload() const { return bytes(F::payload); }
+
+private:
+    using F = encoding::schema::log_entry::Slot;
+};
+
+// Root of a FlatBuffer starting at data.
+template <typename View>
+View root(const uint8_t* data) {
+    return View(data + detail::load<uint32_t>(data));
+}
+
+// EventData: root table with the events vector in field 0.
+class EventDataView : public TableView {
+public:
+    using TableView::TableView;
+    static EventDataView root(const uint8_t* data) { return decoding::root<EventDataView>(data); }
+
+    TableVector<EventView> events() const { return TableVector<EventView>(target(0)); }
+};
+
+// LogData: root table with the logs vector in field 0.
+class LogDataView : public TableView {
+public:
+    using TableView::TableView;
+    static LogDataView root(const uint8_t* data) { return decoding::root<LogDataView>(data); }
+
+    TableVector<LogEntryView> logs() const { return TableVector<LogEntryView>(target(0)); }
+};
+
+class BatchView : public TableView {
+public:
+    using TableView::TableView;
+    // frame excludes the transport's 4-byte length prefix
+    static BatchView root(const uint8_t* frame) { return decoding::root<BatchView>(frame); }
+
+    Bytes api_key() const { return bytes(F::api_key); }
+    SchemaType schema_type() const { return static_cast<SchemaType>(scalar<uint8_t>(F::schema_type)); }
+    uint8_t version() const { return scalar<uint8_t>(F::version); }
+    uint64_t batch_id() const { return scalar<uint64_t>(F::batch_id); }
+    Compression compression() const { return static_cast<Compression>(scalar<uint8_t>(F::compression)); }
+    // Raw data vector; compressed when compression() is not None
+    Bytes data() const { return bytes(F::data); }
+
+    // Uncompressed data only (see decompress_data)
+    EventDataView event_data() const { return EventDataView::root(data().data); }
+    LogDataView log_data() const { return LogDataView::root(data().data); }
+
+private:
+    using F = encoding::schema::batch::Slot;
+};
+
+// Data of a batch, decompressed into out (copied if it is not compressed).
+// False when the codec is unknown or the compressed data is malformed.
+inline bool decompress_data(const BatchView& batch, std::vector<uint8_t>& out) {
+    Bytes data = batch.data();
+    switch (batch.compression()) {
+    case Compression::None:
+        out.assign(data.data, data.data + data.size);
+        return true;
+    case Compression::Lz4: {
+        if (data.size < 4) return false;
+        uint32_t raw_len = detail::load<uint32_t>(data.data);
+        // raw_len is untrusted: don't allocate more than the data can hold
+        if (raw_len > lz4::max_decompressed(data.size - 4)) return false;
+        out.resize(raw_len);
+        return lz4::decompress(data.data + 4, data.size - 4, out.data(), raw_len);
+    }
+    }
+    return false;
+}
+
+// Bounds-checks a frame before it is viewed: every table, vtable, vector and
+// string it reaches must lie inside [data, data + len), strings must be
+// null-terminated and UUID/api_key vectors 16 bytes. Unaligned fields are
+// accepted (views read with memcpy). On failure, error() says what broke.
+class Verifier {
+public:
+    Verifier(const uint8_t* data, size_t len) : data_(data), len_(len) {}
+
+    // Batch table, and the EventData/LogData in it when uncompressed.
+    // Compressed data is checked as bytes only: decompress_data() it and
+    // verify the result with event_data()/log_data().
+    bool batch() {
+        using F = encoding::schema::batch::Slot;
+        size_t table;
+        if (!root(table)) return false;
+        size_t data_pos, data_len;
+        if (!vector(F::api_key, 1, false, encoding::API_KEY_LENGTH) || !scalar(F::schema_type, 1) ||
+            !scalar(F::version, 1) || !scalar(F::batch_id, 8) || !scalar(F::compression, 1) ||
+            !vector(F::data, 1, false, ANY, &data_pos, &data_len)) {
+            return false;
+        }
+        if (data_pos == 0) return fail("batch has no data");
+
+        BatchView view(data_ + table);
+        if (view.compression() == Compression::Lz4) {
+            if (data_len < 4) return fail("compressed data too short");
+            uint32_t raw_len = detail::load<uint32_t>(data_ + data_pos);
+            return raw_len <= lz4::max_decompressed(data_len - 4) || fail("compressed size too large");
+        }
+        if (view.compression() != Compression::None) return fail("unknown compression");
+
+        Verifier inner(data_ + data_pos, data_len);
+        bool ok = view.schema_type() == SchemaType::Event ? inner.event_data()
+                : view.schema_type() == SchemaType::Log   ? inner.log_data()
+                : inner.fail("unknown schema_type");
+        if (!ok) error_ = inner.error_;
+        return ok;
+    }
+
+    bool event_data() {
+        return entries(&Verifier::event);
+    }
+
+    bool log_data() {
+        return entries(&Verifier::log_entry);
+    }
+
+    const char* error() const noexcept { return error_; }
+
+private:
+    static constexpr size_t ANY = SIZE_MAX;
+
+    bool fail(const char* why) {
+        error_ = why;
+        return false;
+    }
+
+    bool in_range(size_t pos, size_t n) const { return pos <= len_ && n <= len_ - pos; }
+
+    bool root(size_t& table) {
+        if (!in_range(0, 4)) return fail("buffer too short for root offset");
+        table = detail::load<uint32_t>(data_);
+        return this->table(table);
+    }
+
+    // Table at pos and its vtable; the field checks below apply to it.
+    bool table(size_t pos) {
+        if (!in_range(pos, 4)) return fail("table out of bounds");
+        int64_t vtable = static_cast<int64_t>(pos) - detail::load<int32_t>(data_ + pos);
+        if (vtable < 0 || !in_range(static_cast<size_t>(vtable), 4)) return fail("vtable out of bounds");
+        uint16_t vtable_size = detail::load<uint16_t>(data_ + vtable);
+        uint16_t table_size = detail::load<uint16_t>(data_ + vtable + 2);
+        if (vtable_size < 4 || vtable_size % 2 != 0 || !in_range(static_cast<size_t>(vtable), vtable_size)) {
+            return fail("malformed vtable");
+        }
+        if (table_size < 4 || !in_range(pos, table_size)) return fail("table size out of bounds");
+        table_ = pos;
+        vtable_ = static_cast<size_t>(vtable);
+        vtable_size_ = vtable_size;
+        table_size_ = table_size;
+        return true;
+    }
+
+    // Offset of field `slot` in the current table (0: absent), checked to
+    // hold `width` bytes inside it.
+    bool field(uint8_t slot, size_t width, uint16_t& offset) {
+        size_t entry = 4 + 2 * static_cast<size_t>(slot);
+        offset = entry < vtable_size_ ? detail::load<uint16_t>(data_ + vtable_ + entry) : 0;
+        if (offset != 0 && (offset < 4 || offset + width > table_size_)) return fail("field outside its table");
+        return true;
+    }
+
+    bool scalar(uint8_t slot, size_t width) {
+        uint16_t offset;
+        return field(slot, width, offset);
+    }
+
+    // Vector (or string) in field `slot`; exact_len = ANY for any length.
+    // *pos/*count receive the contents' position (0 if absent) and length.
+    bool vector(uint8_t slot, size_t elem, bool string, size_t exact_len,
+                size_t* pos = nullptr, size_t* count = nullptr) {
+        uint16_t offset;
+        if (!field(slot, 4, offset)) return false;
+        if (pos) *pos = 0;
+        if (count) *count = 0;
+        if (offset == 0) return true;
+
+        size_t at = table_ + offset;
+        size_t vec = at + detail::load<uint32_t>(data_ + at);
+        if (!in_range(vec, 4)) return fail("vector out of bounds");
+        size_t n = detail::load<uint32_t>(data_ + vec);
+        if (!in_range(vec + 4, n * elem + (string ? 1 : 0))) return fail("vector contents out of bounds");
+        if (string && data_[vec + 4 + n] != 0) return fail("string not null-terminated");
+        if (exact_len != ANY && n != exact_len) return fail("fixed-size vector has the wrong length");
+        if (pos) *pos = vec + 4;
+        if (count) *count = n;
+        return true;
+    }
+
+    bool event(size_t pos) {
+        using F = encoding::schema::event::Slot;
+        return table(pos) && scalar(F::event_type, 1) && scalar(F::timestamp, 8) &&
+               vector(F::service, 1, true, ANY) &&
+               vector(F::device_id, 1, false, encoding::UUID_LENGTH) &&
+               vector(F::session_id, 1, false, encoding::UUID_LENGTH) &&
+               vector(F::event_name, 1, true, ANY) &&
+               vector(F::payload, 1, false, ANY);
+    }
+
+    bool log_entry(size_t pos) {
+        using F = encoding::schema::log_entry::Slot;
+        return table(pos) && scalar(F::event_type, 1) && scalar(F::level, 1) &&
+               scalar(F::timestamp, 8) &&
+               vector(F::session_id, 1, false, encoding::UUID_LENGTH) &&
+               vector(F::source, 1, true, ANY) &&
+               vector(F::service, 1, true, ANY) &&
+               vector(F::payload, 1, false, ANY);
+    }
+
+    // EventData/LogData root and each table in its field-0 vector.
+    bool entries(bool (Verifier::*entry)(size_t)) {
+        size_t table;
+        if (!root(table)) return false;
+        size_t pos, count;
+        if (!vector(0, 4, false, ANY, &pos, &count)) return false;
+        for (size_t i = 0; i < count; i++) {
+            size_t slot = pos + 4 * i;
+            if (!(this->*entry)(slot + detail::load<uint32_t>(data_ + slot))) return false;
+        }
+        return true;
+    }
+
+    const uint8_t* data_;
+    size_t len_;
+    // Current table (last table() that passed)
+    size_t table_ = 0;
+    size_t vtable_ = 0;
+    uint16_t vtable_size_ = 0;
+    uint16_t table_size_ = 0;
+    const char* error_ = nullptr;
+};
+
+} // namespace decoding
+} // namespace tell
@@ -4,9 +4,16 @@
 
 #pragma once
 
+#include "lz4.hpp"
 #include "tell/types.hpp"
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace tell {
@@ -177,6 +184,26 @@ inline void encode_event_into(std::vector<uint8_t>& buf, const EventParams& para
     if (has_payload)    patch_offset(buf, payload_off_pos, payload_start);
 }
 
+// Exact number of bytes encode_event_into appends when buf starts 4-aligned.
+// Root(4) + vtable(18 + 2 pad) + table(36) = 60, then each present vector/string.
+inline size_t encoded_event_size(const EventParams& params) {
+    auto pad4 = [](size_t n) { return (n + 3) & ~size_t(3); };
+    size_t size = 60;
+    if (params.device_id)  size += 4 + UUID_LENGTH;
+    if (params.session_id) size += 4 + UUID_LENGTH;
+    if (params.service)    size += pad4(4 + params.service_len + 1);
+    if (params.event_name) size += pad4(4 + params.event_name_len + 1);
+    if (params.payload && params.payload_len > 0) size += 4 + params.payload_len;
+    return size;
+}
+
+// A standalone event FlatBuffer produced by encode_event_into elsewhere
+// (e.g. on a producer thread), starting with its root offset.
+struct EncodedTable {
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+};
+
 // Encode EventData (vector of events) into buf. Returns start position.
 inline size_t encode_event_data_into(std::vector<uint8_t>& buf, const std::vector<EventParams>& events) {
     size_t data_start = buf.size();
@@ -328,6 +355,18 @@ inline void encode_log_entry_into(std::vector<uint8_t>& buf, const LogEntryParam
     if (has_payload)    patch_offset(buf, payload_off_pos, payload_start);
 }
 
+// Exact number of bytes encode_log_entry_into appends when buf starts 4-aligned.
+// Root(4) + vtable(18 + 2 pad) + table(32) = 56, then each present vector/string.
+inline size_t encoded_log_entry_size(const LogEntryParams& params) {
+    auto pad4 = [](size_t n) { return (n + 3) & ~size_t(3); };
+    size_t size = 56;
+    if (params.session_id) size += 4 + UUID_LENGTH;
+    if (params.source)     size += pad4(4 + params.source_len + 1);
+    if (params.service)    size += pad4(4 + params.service_len + 1);
+    if (params.payload && params.payload_len > 0) size += 4 + params.payload_len;
+    return size;
+}
+
 // Encode LogData (vector of log entries) into buf. Returns start position.
 inline size_t encode_log_data_into(std::vector<uint8_t>& buf, const std::vector<LogEntryParams>& logs) {
     size_t data_start = buf.size();
@@ -383,6 +422,22 @@ inline size_t encode_log_data_into(std::vector<uint8_t>& buf, const std::vector<
     return data_start;
 }
 
+// --- Frame sizing ---
+
+// EventData/LogData wrapper: root(4) + vtable(6 + 2 pad) + table(8) + vector length(4).
+constexpr size_t DATA_OVERHEAD = 24;
+
+// Batch wrapper around data_len bytes of EventData/LogData: root(4) + vtable(16)
+// + table(28) + api_key vector(20) + data vector length(4).
+constexpr size_t BATCH_OVERHEAD = 72;
+
+// Upper bound on what one entry of `entry_size` bytes adds to EventData/LogData:
+// its offset slot plus the table padded to 4 (exact for the reference encoders
+// except for the last entry; shared vtables only make the real size smaller).
+inline size_t data_entry_size(size_t entry_size) {
+    return 4 + ((entry_size + 3) & ~size_t(3));
+}
+
 // --- Batch encoding (matching Rust batch.rs) ---
 
 struct BatchParams {
@@ -392,6 +447,9 @@ struct BatchParams {
     uint64_t batch_id = 0;
     const uint8_t* data = nullptr;
     size_t data_len = 0;
+    // Codec data is compressed with. The reference encoder below only writes
+    // uncompressed batches; see encode_compressed_batch.
+    Compression compression = Compression::None;
 };
 
 inline void encode_batch_into(std::vector<uint8_t>& buf, const BatchParams& params) {
@@ -446,5 +504,876 @@ inline void encode_batch_into(std::vector<uint8_t>& buf, const BatchParams& para
     patch_offset(buf, data_off_pos, data_start);
 }
 
+// --- Exact-size encoding ---
+//
+// Every field length is known from the params, so the whole frame can be
+// sized before writing: the *_exact encoders resize the buffer once and
+// store through a raw cursor, with each offset computed up front instead of
+// patched afterwards. Entries and batch headers are byte-identical to the
+// *_into encoders above, which stay as the reference implementation;
+// EventData/LogData additionally share vtables. buf.size() must be 4-aligned.
+
+// A run of frame bytes living somewhere in memory (see GatherFrame).
+struct Segment {
+    const uint8_t* data = nullptr;
+    size_t len = 0;
+};
+
+// Runs shorter than this are cheaper to copy than to send as their own
+// segment.
+constexpr size_t GATHER_MIN_BYTES = 256;
+
+// Bytes of an n-byte run that Cursor::gather references instead of copying.
+constexpr size_t gathered_size(size_t n) { return n >= GATHER_MIN_BYTES ? n : 0; }
+
+// Raw writer into storage that was already sized. No bounds checks.
+// Stores are host-order memcpys; like patch_u32, this assumes little-endian.
+//
+// pos() is the position in the frame, which offsets are computed from.
+// When gathering, large runs are referenced rather than written, so the
+// frame runs ahead of the storage by the bytes gathered so far.
+class Cursor {
+public:
+    Cursor(uint8_t* base, size_t pos) : out_(base + pos), pos_(pos) {}
+
+    // Gathering cursor: written runs and referenced ones are appended to
+    // segments in frame order. Call end_run() after the last write.
+    Cursor(uint8_t* base, size_t pos, std::vector<Segment>& segments)
+        : out_(base + pos), pos_(pos), segments_(&segments), run_(out_) {}
+
+    size_t pos() const noexcept { return pos_; }
+
+    void u8(uint8_t value) { *out_++ = value; pos_++; }
+    void u16(uint16_t value) { store(&value, 2); }
+    void u32(uint32_t value) { store(&value, 4); }
+    void i32(int32_t value) { store(&value, 4); }
+    void u64(uint64_t value) { store(&value, 8); }
+    void zeros(size_t n) { std::memset(out_, 0, n); out_ += n; pos_ += n; }
+    void bytes(const void* data, size_t n) { if (n > 0) store(data, n); }
+
+    // Bytes that stay valid until the frame is sent: referenced in place
+    // when gathering and at least GATHER_MIN_BYTES long, copied otherwise.
+    void gather(const uint8_t* data, size_t n) {
+        if (!segments_ || gathered_size(n) == 0) {
+            bytes(data, n);
+            return;
+        }
+        end_run();
+        segments_->push_back({data, n});
+        pos_ += n;
+    }
+
+    // Close the run of bytes written since the last segment.
+    void end_run() {
+        if (out_ != run_) segments_->push_back({run_, static_cast<size_t>(out_ - run_)});
+        run_ = out_;
+    }
+
+    // uoffset stored here pointing forward at `target`.
+    void offset_to(size_t target) { u32(static_cast<uint32_t>(target - pos_)); }
+    void offset_to_if(bool present, size_t target) { u32(present ? static_cast<uint32_t>(target - pos_) : 0); }
+
+    void align4() { zeros((4 - (pos_ & 3)) & 3); }
+
+    // [u32 length][data]
+    void byte_vector(const uint8_t* data, size_t len) {
+        u32(len > UINT32_MAX ? 0 : static_cast<uint32_t>(len));
+        if (data) bytes(data, len);
+    }
+
+    // byte_vector whose data may be gathered
+    void gather_vector(const uint8_t* data, size_t len) {
+        u32(len > UINT32_MAX ? 0 : static_cast<uint32_t>(len));
+        if (data) gather(data, len);
+    }
+
+    // [u32 length][data][null]
+    void string(const char* s, size_t len) {
+        u32(len > UINT32_MAX ? 0 : static_cast<uint32_t>(len));
+        if (s) bytes(s, len);
+        u8(0);
+    }
+
+private:
+    void store(const void* data, size_t n) { std::memcpy(out_, data, n); out_ += n; pos_ += n; }
+
+    uint8_t* out_;
+    size_t pos_;
+    std::vector<Segment>* segments_ = nullptr;
+    const uint8_t* run_ = nullptr;
+};
+
+constexpr size_t pad4(size_t n) { return (n + 3) & ~size_t(3); }
+
+// --- Table schemas ---
+//
+// Each table is described once: its fields in layout order, each with its
+// vtable slot and kind. Inline offsets (aligned to min(width, 4), as the
+// Rust encoder lays them out), table size and vtable contents are derived at
+// compile time, and write_table<TABLE> stores a row of values with all of
+// them folded in as constants. A new schema version is a new TABLE.
+// The *_into reference encoders above stay hand-written.
+
+namespace schema {
+
+enum class Kind : uint8_t { U8, U64, Offset };
+
+constexpr size_t width(Kind kind) { return kind == Kind::U8 ? 1 : kind == Kind::U64 ? 8 : 4; }
+
+struct Field {
+    uint8_t slot;
+    Kind kind;
+};
+
+template <size_t N, size_t Slots>
+struct Table {
+    static constexpr size_t FIELDS = N;
+    static constexpr size_t SLOTS = Slots;
+    static constexpr uint16_t VTABLE_SIZE = 4 + 2 * Slots;
+    using VTable = std::array<uint16_t, 2 + Slots>;
+    // Field values by slot: scalars as-is, Offset fields as the absolute
+    // position of their target (0 when absent)
+    using Row = std::array<uint64_t, Slots>;
+
+    std::array<Field, N> fields;
+    std::array<uint16_t, N> offsets{};  // from the table start (soffset at 0)
+    uint16_t size = 0;                  // table bytes, padded to 4
+    uint16_t declared_size = 0;         // table_size written in the vtable
+
+    constexpr Table(std::array<Field, N> layout, uint16_t declared = 0) : fields(layout) {
+        size_t pos = 4;
+        for (size_t i = 0; i < N; i++) {
+            size_t align = width(fields[i].kind) < 4 ? width(fields[i].kind) : 4;
+            pos = (pos + align - 1) / align * align;
+            offsets[i] = static_cast<uint16_t>(pos);
+            pos += width(fields[i].kind);
+        }
+        size = static_cast<uint16_t>(pad4(pos));
+        declared_size = declared != 0 ? declared : size;
+    }
+};
+
+constexpr uint32_t bit(uint8_t slot) { return 1u << slot; }
+
+// Event (event.rs)
+namespace event {
+enum Slot : uint8_t { event_type, timestamp, service, device_id, session_id, event_name, payload };
+
+constexpr Table<7, 7> TABLE({{
+    {device_id, Kind::Offset},
+    {session_id, Kind::Offset},
+    {event_name, Kind::Offset},
+    {payload, Kind::Offset},
+    {timestamp, Kind::U64},
+    {event_type, Kind::U8},
+    {service, Kind::Offset},
+}});
+using Row = std::decay_t<decltype(TABLE)>::Row;
+} // namespace event
+
+// Log entry (log.rs)
+namespace log_entry {
+enum Slot : uint8_t { event_type, session_id, level, timestamp, source, service, payload };
+
+constexpr Table<7, 7> TABLE({{
+    {session_id, Kind::Offset},
+    {source, Kind::Offset},
+    {service, Kind::Offset},
+    {payload, Kind::Offset},
+    {timestamp, Kind::U64},
+    {event_type, Kind::U8},
+    {level, Kind::U8},
+}});
+using Row = std::decay_t<decltype(TABLE)>::Row;
+} // namespace log_entry
+
+// Batch (batch.rs). source_ip keeps its inline space but is never set, and
+// the vtable has always declared a 32-byte table; both kept for the wire.
+// Compressed batches use COMPRESSED_TABLE, which adds the compression codec
+// in the padding after version; uncompressed frames are unchanged.
+namespace batch {
+enum Slot : uint8_t { api_key, schema_type, version, batch_id, data, source_ip, compression };
+
+constexpr Table<6, 6> TABLE({{
+    {api_key, Kind::Offset},
+    {data, Kind::Offset},
+    {source_ip, Kind::Offset},
+    {batch_id, Kind::U64},
+    {schema_type, Kind::U8},
+    {version, Kind::U8},
+}}, 32);
+
+constexpr Table<7, 7> COMPRESSED_TABLE({{
+    {api_key, Kind::Offset},
+    {data, Kind::Offset},
+    {source_ip, Kind::Offset},
+    {batch_id, Kind::U64},
+    {schema_type, Kind::U8},
+    {version, Kind::U8},
+    {compression, Kind::U8},
+}}, 32);
+} // namespace batch
+
+// Same layouts as the hand-written reference encoders
+static_assert(event::TABLE.size == 36 && log_entry::TABLE.size == 32 && batch::TABLE.size == 28,
+              "schema layout drifted from the reference encoders");
+static_assert(batch::COMPRESSED_TABLE.size == batch::TABLE.size,
+              "compression must fit the batch table's padding");
+
+template <const auto& TABLE>
+using TableOf = std::decay_t<decltype(TABLE)>;
+
+// The per-field helpers are expanded over an index_sequence so each field's
+// slot, kind and offset is a template constant: no loops or switches remain.
+
+template <const auto& TABLE, size_t... I>
+typename TableOf<TABLE>::VTable vtable(uint32_t present, std::index_sequence<I...>) {
+    typename TableOf<TABLE>::VTable vt{};
+    vt[0] = TABLE.VTABLE_SIZE;
+    vt[1] = TABLE.declared_size;
+    ((vt[2 + TABLE.fields[I].slot] = (present & (1u << TABLE.fields[I].slot)) ? TABLE.offsets[I] : 0), ...);
+    return vt;
+}
+
+// VTable listing the fields whose slot bit is set in `present`.
+template <const auto& TABLE>
+typename TableOf<TABLE>::VTable vtable(uint32_t present) {
+    return vtable<TABLE>(present, std::make_index_sequence<TABLE.FIELDS>());
+}
+
+template <const auto& TABLE, size_t I>
+void write_field(Cursor& c, const typename TableOf<TABLE>::Row& row) {
+    constexpr Field field = TABLE.fields[I];
+    constexpr size_t end_of_previous = I == 0 ? 4 : TABLE.offsets[I - 1] + width(TABLE.fields[I - 1].kind);
+    constexpr size_t pad = TABLE.offsets[I] - end_of_previous;
+    if constexpr (pad > 0) c.zeros(pad);
+
+    uint64_t value = row[field.slot];
+    if constexpr (field.kind == Kind::U8) c.u8(static_cast<uint8_t>(value));
+    else if constexpr (field.kind == Kind::U64) c.u64(value);
+    else c.offset_to_if(value != 0, value);
+}
+
+template <const auto& TABLE, size_t... I>
+void write_table(Cursor& c, size_t vtable_pos, const typename TableOf<TABLE>::Row& row,
+                 std::index_sequence<I...>) {
+    c.i32(static_cast<int32_t>(c.pos() - vtable_pos));
+    (write_field<TABLE, I>(c, row), ...);
+    constexpr size_t last = TABLE.FIELDS - 1;
+    constexpr size_t tail = TABLE.size - (TABLE.offsets[last] + width(TABLE.fields[last].kind));
+    if constexpr (tail > 0) c.zeros(tail);
+}
+
+// Table at a 4-aligned cursor, pointing at the vtable at vtable_pos.
+template <const auto& TABLE>
+void write_table(Cursor& c, size_t vtable_pos, const typename TableOf<TABLE>::Row& row) {
+    write_table<TABLE>(c, vtable_pos, row, std::make_index_sequence<TABLE.FIELDS>());
+}
+
+template <typename VTable>
+void write_vtable(Cursor& c, const VTable& vtable) {
+    for (uint16_t slot : vtable) c.u16(slot);
+    c.zeros(pad4(sizeof(VTable)) - sizeof(VTable));
+}
+
+} // namespace schema
+
+// Event and log vtables: vtable_size, table_size, then 7 field slots.
+using EntryVTable = std::decay_t<decltype(schema::event::TABLE)>::VTable;
+static_assert(std::is_same<EntryVTable, std::decay_t<decltype(schema::log_entry::TABLE)>::VTable>::value,
+              "events and logs share the EntryVTable shape");
+
+// Bytes one EntryVTable takes in the buffer (18 + 2 pad).
+constexpr size_t ENTRY_VTABLE_BYTES = pad4(sizeof(EntryVTable));
+
+// Root offset of every standalone event/log table: root(4) + vtable(18 + 2 pad).
+constexpr uint32_t ENTRY_ROOT_OFFSET = 4 + ENTRY_VTABLE_BYTES;
+
+inline void write_vtable(Cursor& c, const EntryVTable& vtable) { schema::write_vtable(c, vtable); }
+
+inline EntryVTable event_vtable(const EventParams& params) {
+    using namespace schema::event;
+    return schema::vtable<TABLE>(schema::bit(event_type) | schema::bit(timestamp) |
+                        (params.service ? schema::bit(service) : 0) |
+                        (params.device_id ? schema::bit(device_id) : 0) |
+                        (params.session_id ? schema::bit(session_id) : 0) |
+                        (params.event_name ? schema::bit(event_name) : 0) |
+                        (params.payload && params.payload_len > 0 ? schema::bit(payload) : 0));
+}
+
+// Bytes a string takes in the buffer: [u32 length][data][null], padded to 4.
+inline size_t string_size(size_t len) { return pad4(4 + len + 1); }
+
+// Write an event table and its vectors at a 4-aligned cursor, pointing at a
+// vtable already written at vtable_pos. Strings are written inline, or, if
+// pooled is given, referenced at pooled[0] (service) and pooled[1]
+// (event_name) and left out. Exactly event_table_size(params, pooled) bytes.
+inline void write_event_table(Cursor& c, const EventParams& params, size_t vtable_pos,
+                              const size_t* pooled = nullptr) {
+    bool has_device_id = params.device_id != nullptr;
+    bool has_session_id = params.session_id != nullptr;
+    bool has_service = params.service != nullptr;
+    bool has_event_name = params.event_name != nullptr;
+    bool has_payload = params.payload != nullptr && params.payload_len > 0;
+    bool inline_strings = pooled == nullptr;
+
+    // Vectors and strings follow the table in field order
+    size_t at = c.pos() + schema::event::TABLE.size;
+    size_t device_id_at = at;   if (has_device_id)  at += 4 + UUID_LENGTH;
+    size_t session_id_at = at;  if (has_session_id) at += 4 + UUID_LENGTH;
+    size_t service_at = inline_strings ? at : pooled[0];
+    if (inline_strings && has_service) at += string_size(params.service_len);
+    size_t event_name_at = inline_strings ? at : pooled[1];
+    if (inline_strings && has_event_name) at += string_size(params.event_name_len);
+    size_t payload_at = at;
+
+    using namespace schema::event;
+    Row row{};
+    row[event_type] = static_cast<uint8_t>(params.event_type);
+    row[timestamp] = params.timestamp;
+    row[service] = has_service ? service_at : 0;
+    row[device_id] = has_device_id ? device_id_at : 0;
+    row[session_id] = has_session_id ? session_id_at : 0;
+    row[event_name] = has_event_name ? event_name_at : 0;
+    row[payload] = has_payload ? payload_at : 0;
+    schema::write_table<TABLE>(c, vtable_pos, row);
+
+    if (has_device_id)  c.byte_vector(params.device_id, UUID_LENGTH);
+    if (has_session_id) c.byte_vector(params.session_id, UUID_LENGTH);
+    if (inline_strings) {
+        if (has_service)    { c.string(params.service, params.service_len); c.align4(); }
+        if (has_event_name) { c.string(params.event_name, params.event_name_len); c.align4(); }
+    }
+    if (has_payload)    c.gather_vector(params.payload, params.payload_len);
+}
+
+inline size_t event_table_size(const EventParams& params, bool pooled) {
+    size_t size = encoded_event_size(params) - ENTRY_ROOT_OFFSET;
+    if (pooled && params.service)    size -= string_size(params.service_len);
+    if (pooled && params.event_name) size -= string_size(params.event_name_len);
+    return size;
+}
+
+// Write one standalone event at a 4-aligned cursor; exactly encoded_event_size(params) bytes.
+inline void write_event(Cursor& c, const EventParams& params) {
+    c.u32(ENTRY_ROOT_OFFSET);
+    size_t vtable_pos = c.pos();
+    write_vtable(c, event_vtable(params));
+    write_event_table(c, params, vtable_pos);
+}
+
+inline EntryVTable log_vtable(const LogEntryParams& params) {
+    using namespace schema::log_entry;
+    return schema::vtable<TABLE>(schema::bit(event_type) | schema::bit(level) | schema::bit(timestamp) |
+                        (params.session_id ? schema::bit(session_id) : 0) |
+                        (params.source ? schema::bit(source) : 0) |
+                        (params.service ? schema::bit(service) : 0) |
+                        (params.payload && params.payload_len > 0 ? schema::bit(payload) : 0));
+}
+
+// Log counterpart of write_event_table; pooled[0] is source,
+// pooled[1] service.
+inline void write_log_table(Cursor& c, const LogEntryParams& params, size_t vtable_pos,
+                            const size_t* pooled = nullptr) {
+    bool has_session_id = params.session_id != nullptr;
+    bool has_source = params.source != nullptr;
+    bool has_service = params.service != nullptr;
+    bool has_payload = params.payload != nullptr && params.payload_len > 0;
+    bool inline_strings = pooled == nullptr;
+
+    size_t at = c.pos() + schema::log_entry::TABLE.size;
+    size_t session_id_at = at;  if (has_session_id) at += 4 + UUID_LENGTH;
+    size_t source_at = inline_strings ? at : pooled[0];
+    if (inline_strings && has_source) at += string_size(params.source_len);
+    size_t service_at = inline_strings ? at : pooled[1];
+    if (inline_strings && has_service) at += string_size(params.service_len);
+    size_t payload_at = at;
+
+    using namespace schema::log_entry;
+    Row row{};
+    row[event_type] = static_cast<uint8_t>(params.event_type);
+    row[session_id] = has_session_id ? session_id_at : 0;
+    row[level] = static_cast<uint8_t>(params.level);
+    row[timestamp] = params.timestamp;
+    row[source] = has_source ? source_at : 0;
+    row[service] = has_service ? service_at : 0;
+    row[payload] = has_payload ? payload_at : 0;
+    schema::write_table<TABLE>(c, vtable_pos, row);
+
+    if (has_session_id) c.byte_vector(params.session_id, UUID_LENGTH);
+    if (inline_strings) {
+        if (has_source)  { c.string(params.source, params.source_len); c.align4(); }
+        if (has_service) { c.string(params.service, params.service_len); c.align4(); }
+    }
+    if (has_payload)    c.gather_vector(params.payload, params.payload_len);
+}
+
+inline size_t log_table_size(const LogEntryParams& params, bool pooled) {
+    size_t size = encoded_log_entry_size(params) - ENTRY_ROOT_OFFSET;
+    if (pooled && params.source)  size -= string_size(params.source_len);
+    if (pooled && params.service) size -= string_size(params.service_len);
+    return size;
+}
+
+// Write one standalone log entry at a 4-aligned cursor; exactly encoded_log_entry_size(params) bytes.
+inline void write_log_entry(Cursor& c, const LogEntryParams& params) {
+    c.u32(ENTRY_ROOT_OFFSET);
+    size_t vtable_pos = c.pos();
+    write_vtable(c, log_vtable(params));
+    write_log_table(c, params, vtable_pos);
+}
+
+// A string written once per batch and shared by every table that uses it.
+struct PooledString {
+    const char* data = nullptr;  // nullptr: field absent
+    size_t len = 0;
+
+    bool operator==(const PooledString& o) const {
+        return len == o.len && (data == o.data || std::memcmp(data, o.data, len) == 0);
+    }
+};
+
+// Adapters describing each entry type to the EventData/LogData writer: its
+// vtable, its POOLED strings, its table (plus vectors) written against a
+// shared vtable with strings at the given pool positions, and how many of
+// those bytes a gathering cursor references in place.
+struct EventEntries {
+    static constexpr size_t POOLED = 2;
+    static EntryVTable vtable(const EventParams& p) { return event_vtable(p); }
+    static std::array<PooledString, POOLED> strings(const EventParams& p) {
+        return {{{p.service, p.service_len}, {p.event_name, p.event_name_len}}};
+    }
+    static size_t table_size(const EventParams& p) { return event_table_size(p, true); }
+    static size_t gathered(const EventParams& p) { return p.payload ? gathered_size(p.payload_len) : 0; }
+    static void write_table(Cursor& c, const EventParams& p, size_t vtable_pos, const size_t* pooled) {
+        write_event_table(c, p, vtable_pos, pooled);
+    }
+};
+
+struct LogEntries {
+    static constexpr size_t POOLED = 2;
+    static EntryVTable vtable(const LogEntryParams& p) { return log_vtable(p); }
+    static std::array<PooledString, POOLED> strings(const LogEntryParams& p) {
+        return {{{p.source, p.source_len}, {p.service, p.service_len}}};
+    }
+    static size_t table_size(const LogEntryParams& p) { return log_table_size(p, true); }
+    static size_t gathered(const LogEntryParams& p) { return p.payload ? gathered_size(p.payload_len) : 0; }
+    static void write_table(Cursor& c, const LogEntryParams& p, size_t vtable_pos, const size_t* pooled) {
+        write_log_table(c, p, vtable_pos, pooled);
+    }
+};
+
+// Standalone events from encode_event_exact: the table is copied from behind
+// its own vtable and its soffset re-pointed at the shared one. Their strings
+// are already inline, so nothing is pooled.
+struct TableEntries {
+    static constexpr size_t POOLED = 0;
+    static uint32_t root(const EncodedTable& t) {
+        uint32_t root_offset;
+        std::memcpy(&root_offset, t.data, 4);
+        return root_offset;
+    }
+    static EntryVTable vtable(const EncodedTable& t) {
+        int32_t soffset;
+        std::memcpy(&soffset, t.data + root(t), 4);
+        EntryVTable vtable;
+        std::memcpy(vtable.data(), t.data + root(t) - soffset, sizeof(vtable));
+        return vtable;
+    }
+    static std::array<PooledString, POOLED> strings(const EncodedTable&) { return {}; }
+    static size_t table_size(const EncodedTable& t) { return t.len - root(t); }
+    static size_t gathered(const EncodedTable& t) { return gathered_size(t.len - root(t) - 4); }
+    static void write_table(Cursor& c, const EncodedTable& t, size_t vtable_pos, const size_t*) {
+        c.i32(static_cast<int32_t>(c.pos() - vtable_pos));
+        c.gather(t.data + root(t) + 4, t.len - root(t) - 4);
+    }
+};
+
+// EventData/LogData layout with shared vtables and pooled strings:
+//   root(4) + vtable(6 + 2 pad) + table(8)
+//   entries vector: count, then one offset per entry
+//   each distinct entry vtable once, in first-use order
+//   entry tables (4-aligned), each followed by its non-string vectors
+//   string pool (4-aligned): each distinct string once, in first-use order
+// Entry tables point back at their vtable (positive soffset) and forward at
+// their strings, as FlatBuffers builders do for shared vtables and strings.
+// Most batches share one or two vtables and a handful of names.
+template <typename Entries, typename Entry>
+struct DataLayout {
+    static constexpr size_t POOLED = Entries::POOLED;
+
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct PoolEntry {
+        PooledString str;
+        uint32_t at;  // pool-relative position
+    };
+
+    // Per entry: its vtable and pooled strings (NONE: absent)
+    struct EntryRefs {
+        uint32_t vtable;
+        std::array<uint32_t, POOLED> strings;
+    };
+
+    std::vector<EntryVTable> vtables;  // distinct, in first-use order
+    std::vector<PoolEntry> strings;    // distinct, in first-use order
+    std::vector<EntryRefs> refs;
+    size_t pool_bytes = 0;
+    size_t size = DATA_OVERHEAD;
+
+    explicit DataLayout(const std::vector<Entry>& entries) {
+        vtables.reserve(4);
+        strings.reserve(SCAN_LIMIT);
+        refs.reserve(entries.size());
+        last_string_.fill(NONE);
+        for (const auto& e : entries) {
+            EntryRefs r;
+            r.vtable = index_of(Entries::vtable(e));
+            auto fields = Entries::strings(e);
+            for (size_t f = 0; f < POOLED; f++) {
+                r.strings[f] = fields[f].data ? pool(fields[f], f) : NONE;
+            }
+            refs.push_back(r);
+            // Offset slot plus the table padded to 4 (the last is not padded)
+            size = pad4(size) + 4 + Entries::table_size(e);
+        }
+        size += vtables.size() * ENTRY_VTABLE_BYTES;
+        if (pool_bytes > 0) size = pad4(size) + pool_bytes;
+    }
+
+    void write(Cursor& c, const std::vector<Entry>& entries) const {
+        size_t count = entries.size();
+
+        c.u32(12);      // root -> table
+        c.u16(6);       // vtable_size
+        c.u16(8);       // table_size
+        c.u16(4);       // field 0: entries at table+4
+        c.zeros(2);
+        c.i32(8);       // soffset -> vtable
+        c.u32(4);       // entries vector follows the table
+        c.u32(static_cast<uint32_t>(count));
+
+        size_t vtables_pos = c.pos() + count * 4;
+        size_t entry_start = vtables_pos + vtables.size() * ENTRY_VTABLE_BYTES;
+        for (const auto& e : entries) {
+            c.offset_to(entry_start);
+            entry_start = pad4(entry_start + Entries::table_size(e));
+        }
+        size_t pool_pos = entry_start;  // entry_start is now past the last table, 4-aligned
+
+        for (const auto& vtable : vtables) write_vtable(c, vtable);
+        for (size_t i = 0; i < count; i++) {
+            size_t pooled[POOLED > 0 ? POOLED : 1] = {};
+            for (size_t f = 0; f < POOLED; f++) {
+                uint32_t s = refs[i].strings[f];
+                if (s != NONE) pooled[f] = pool_pos + strings[s].at;
+            }
+            c.align4();
+            Entries::write_table(c, entries[i], vtables_pos + refs[i].vtable * ENTRY_VTABLE_BYTES, pooled);
+        }
+
+        if (strings.empty()) return;
+        c.align4();
+        for (const auto& entry : strings) {
+            c.string(entry.str.data, entry.str.len);
+            c.align4();
+        }
+    }
+
+private:
+    // Index of vtable in vtables, adding it if new. Runs of entries share a
+    // vtable, so the previous match is checked first.
+    uint32_t index_of(const EntryVTable& vtable) {
+        if (last_vtable_ < vtables.size() && same(vtables[last_vtable_], vtable)) return last_vtable_;
+        auto it = std::find_if(vtables.begin(), vtables.end(),
+                               [&](const EntryVTable& v) { return same(v, vtable); });
+        if (it == vtables.end()) it = vtables.insert(it, vtable);
+        last_vtable_ = static_cast<uint32_t>(it - vtables.begin());
+        return last_vtable_;
+    }
+
+    // A fixed-size memcmp compiles to a few loads; array== goes through std::equal.
+    static bool same(const EntryVTable& a, const EntryVTable& b) {
+        return std::memcmp(a.data(), b.data(), sizeof(EntryVTable)) == 0;
+    }
+
+    // Index of str in strings, adding it to the pool if new. Each field first
+    // checks its previous string (service is usually one shared pointer);
+    // small pools are scanned, larger ones get an open-addressed hash table.
+    uint32_t pool(const PooledString& str, size_t field) {
+        uint32_t& last = last_string_[field];
+        if (last != NONE && strings[last].str == str) return last;
+
+        if (strings.size() < SCAN_LIMIT) {
+            auto it = std::find_if(strings.begin(), strings.end(),
+                                   [&](const PoolEntry& p) { return p.str == str; });
+            last = it != strings.end() ? static_cast<uint32_t>(it - strings.begin()) : add(str);
+            return last;
+        }
+        if (slots_.empty()) {
+            // Sized for every string the batch could hold
+            size_t n = 16;
+            while (n < refs.capacity() * POOLED * 2) n *= 2;
+            slots_.assign(n, NONE);
+            for (uint32_t i = 0; i < strings.size(); i++) *slot_of(strings[i].str) = i;
+        }
+        uint32_t* slot = slot_of(str);
+        if (*slot == NONE) *slot = add(str);
+        last = *slot;
+        return last;
+    }
+
+    uint32_t add(const PooledString& str) {
+        strings.push_back({str, static_cast<uint32_t>(pool_bytes)});
+        pool_bytes += string_size(str.len);
+        return static_cast<uint32_t>(strings.size() - 1);
+    }
+
+    // Slot holding str, or the empty slot where it belongs (load factor <= 0.5)
+    uint32_t* slot_of(const PooledString& str) {
+        size_t mask = slots_.size() - 1;
+        size_t i = std::hash<std::string_view>()(std::string_view(str.data, str.len)) & mask;
+        while (slots_[i] != NONE && !(strings[slots_[i]].str == str)) i = (i + 1) & mask;
+        return &slots_[i];
+    }
+
+    static constexpr size_t SCAN_LIMIT = 8;
+
+    uint32_t last_vtable_ = 0;
+    std::array<uint32_t, POOLED> last_string_;
+    std::vector<uint32_t> slots_;
+};
+
+inline size_t encoded_event_data_size(const std::vector<EventParams>& events) {
+    return DataLayout<EventEntries, EventParams>(events).size;
+}
+
+inline size_t encoded_log_data_size(const std::vector<LogEntryParams>& logs) {
+    return DataLayout<LogEntries, LogEntryParams>(logs).size;
+}
+
+template <typename Entries, typename Entry>
+size_t encode_data_exact(std::vector<uint8_t>& buf, const std::vector<Entry>& entries) {
+    DataLayout<Entries, Entry> layout(entries);
+    size_t data_start = buf.size();
+    buf.resize(data_start + layout.size);
+    Cursor c(buf.data(), data_start);
+    layout.write(c, entries);
+    return data_start;
+}
+
+// Unlike the reference encoders, these share vtables across entries (see
+// DataLayout), so the output is smaller but not byte-identical.
+inline size_t encode_event_data_exact(std::vector<uint8_t>& buf, const std::vector<EventParams>& events) {
+    return encode_data_exact<EventEntries>(buf, events);
+}
+
+inline size_t encode_log_data_exact(std::vector<uint8_t>& buf, const std::vector<LogEntryParams>& logs) {
+    return encode_data_exact<LogEntries>(buf, logs);
+}
+
+inline void encode_event_exact(std::vector<uint8_t>& buf, const EventParams& params) {
+    size_t start = buf.size();
+    buf.resize(start + encoded_event_size(params));
+    Cursor c(buf.data(), start);
+    write_event(c, params);
+}
+
+inline void encode_log_entry_exact(std::vector<uint8_t>& buf, const LogEntryParams& params) {
+    size_t start = buf.size();
+    buf.resize(start + encoded_log_entry_size(params));
+    Cursor c(buf.data(), start);
+    write_log_entry(c, params);
+}
+
+// Bytes before the data vector's contents in a frame using TABLE.
+template <const auto& TABLE>
+constexpr size_t batch_header_size() {
+    return 4 + pad4(TABLE.VTABLE_SIZE) + TABLE.size + 4 + API_KEY_LENGTH + 4;
+}
+
+static_assert(batch_header_size<schema::batch::TABLE>() == BATCH_OVERHEAD, "BATCH_OVERHEAD drifted");
+
+// Header of a compressed frame: its vtable has one more slot.
+constexpr size_t COMPRESSED_BATCH_OVERHEAD = batch_header_size<schema::batch::COMPRESSED_TABLE>();
+
+template <const auto& TABLE>
+void write_batch_table(Cursor& c, const BatchParams& params, size_t data_len) {
+    using namespace schema::batch;
+    constexpr size_t vtable_at = 4;
+    constexpr size_t table_at = vtable_at + pad4(TABLE.VTABLE_SIZE);
+    constexpr size_t api_key_at = table_at + TABLE.size;
+    constexpr size_t data_at = api_key_at + 4 + API_KEY_LENGTH;
+    constexpr bool compressed = TABLE.SLOTS > compression;
+    size_t base = c.pos();
+
+    c.u32(table_at);  // root -> table
+    schema::write_vtable(c, schema::vtable<TABLE>(schema::bit(api_key) | schema::bit(schema_type) |
+                                         schema::bit(version) | schema::bit(data) |
+                                         (params.batch_id != 0 ? schema::bit(batch_id) : 0) |
+                                         (compressed ? schema::bit(compression) : 0)));
+    typename schema::TableOf<TABLE>::Row row{};
+    row[api_key] = base + api_key_at;
+    row[schema_type] = static_cast<uint8_t>(params.schema_type);
+    row[version] = params.version == 0 ? DEFAULT_VERSION : params.version;
+    row[batch_id] = params.batch_id;
+    row[data] = base + data_at;
+    if constexpr (compressed) row[compression] = static_cast<uint8_t>(params.compression);
+    schema::write_table<TABLE>(c, base + vtable_at, row);
+
+    c.byte_vector(params.api_key, API_KEY_LENGTH);
+    c.u32(data_len > UINT32_MAX ? 0 : static_cast<uint32_t>(data_len));
+}
+
+// Batch table and api_key vector, up to and including the data vector's
+// length; the data_len bytes of data follow (4-aligned). BATCH_OVERHEAD
+// bytes, or COMPRESSED_BATCH_OVERHEAD when params.compression is set.
+inline void write_batch_header(Cursor& c, const BatchParams& params, size_t data_len) {
+    if (params.compression == Compression::None) {
+        write_batch_table<schema::batch::TABLE>(c, params, data_len);
+    } else {
+        write_batch_table<schema::batch::COMPRESSED_TABLE>(c, params, data_len);
+    }
+}
+
+inline void encode_batch_exact(std::vector<uint8_t>& buf, const BatchParams& params) {
+    size_t base = buf.size();
+    size_t header = params.compression == Compression::None ? BATCH_OVERHEAD : COMPRESSED_BATCH_OVERHEAD;
+    buf.resize(base + header + params.data_len);
+    Cursor c(buf.data(), base);
+    write_batch_header(c, params, params.data_len);
+    if (params.data) c.bytes(params.data, params.data_len);
+}
+
+// --- Compressed batches ---
+//
+// The data vector holds [u32 raw length (LE)][LZ4 block] and the batch
+// carries compression = Lz4 (lz4_flex's compress_prepend_size layout).
+
+// Frame for params.data (uncompressed) with the data compressed by codec,
+// falling back to the plain encode_batch_exact frame when that is no
+// smaller. Returns whether the frame is compressed.
+inline bool encode_compressed_batch(std::vector<uint8_t>& buf, BatchParams params, Compression codec) {
+    size_t base = buf.size();
+    if (codec == Compression::Lz4 && params.data_len <= UINT32_MAX) {
+        constexpr size_t header = COMPRESSED_BATCH_OVERHEAD + 4;
+        buf.resize(base + header + lz4::bound(params.data_len));
+        size_t packed = lz4::compress(params.data, params.data_len, buf.data() + base + header);
+        if (header + packed < BATCH_OVERHEAD + params.data_len) {
+            buf.resize(base + header + packed);
+            params.compression = codec;
+            Cursor c(buf.data(), base);
+            write_batch_header(c, params, 4 + packed);
+            c.u32(static_cast<uint32_t>(params.data_len));
+            return true;
+        }
+        buf.resize(base);
+    }
+    params.compression = Compression::None;
+    encode_batch_exact(buf, params);
+    return false;
+}
+
+// --- Scatter-gather batch encoding ---
+//
+// Encodes a whole frame in one pass as a list of segments for
+// writev/sendmsg: the batch header and the data vector's length come first,
+// then EventData/LogData in place behind them. Headers, vtables, tables and
+// small vectors are written to a small head buffer, and payloads (or
+// producer-encoded tables) of at least GATHER_MIN_BYTES are referenced where
+// they already live, so large payload bytes are never copied on their way to
+// the socket. params.data/data_len are ignored and params.compression must
+// be None. Same bytes as encode_batch_exact over the matching *_data_exact
+// output.
+
+// A frame as segments; concatenated, they are the frame's bytes.
+// Segments point into head and into the entries' payloads, which must stay
+// alive and unchanged until the frame has been sent.
+struct GatherFrame {
+    std::vector<uint8_t> head;
+    std::vector<Segment> segments;
+
+    void clear() {
+        head.clear();
+        segments.clear();
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& s : segments) total += s.len;
+        return total;
+    }
+
+    // Contiguous copy, for callers that must outlive the payloads (retries).
+    std::vector<uint8_t> flatten() const {
+        std::vector<uint8_t> out;
+        out.reserve(size());
+        for (const auto& s : segments) out.insert(out.end(), s.data, s.data + s.len);
+        return out;
+    }
+};
+
+template <typename Entries, typename Entry>
+void gather_nested_batch(GatherFrame& frame, const BatchParams& params,
+                         const std::vector<Entry>& entries) {
+    DataLayout<Entries, Entry> layout(entries);
+    size_t gathered = 0;
+    for (const auto& e : entries) gathered += Entries::gathered(e);
+
+    frame.clear();
+    frame.head.resize(BATCH_OVERHEAD + layout.size - gathered);
+    Cursor c(frame.head.data(), 0, frame.segments);
+    write_batch_header(c, params, layout.size);
+    layout.write(c, entries);
+    c.end_run();
+}
+
+inline void gather_event_batch(GatherFrame& frame, const BatchParams& params,
+                               const std::vector<EventParams>& events) {
+    gather_nested_batch<EventEntries>(frame, params, events);
+}
+
+inline void gather_log_batch(GatherFrame& frame, const BatchParams& params,
+                             const std::vector<LogEntryParams>& logs) {
+    gather_nested_batch<LogEntries>(frame, params, logs);
+}
+
+// Producer-encoded tables are referenced whole (all but their soffset,
+// which is re-pointed at the shared vtable in the head).
+inline void gather_event_tables_batch(GatherFrame& frame, const BatchParams& params,
+                                      const std::vector<EncodedTable>& tables) {
+    gather_nested_batch<TableEntries>(frame, params, tables);
+}
+
+// --- Contiguous batch encoding ---
+//
+// The gather encoders' frame copied into one buffer (appended to buf), for
+// callers that want the bytes in one place, such as tests, benchmarks and
+// tools replaying frames. The worker sends gather frames directly.
+
+template <typename Entries, typename Entry>
+void encode_nested_batch(std::vector<uint8_t>& buf, const BatchParams& params,
+                         const std::vector<Entry>& entries) {
+    GatherFrame frame;
+    gather_nested_batch<Entries>(frame, params, entries);
+    buf.reserve(buf.size() + frame.size());
+    for (const auto& s : frame.segments) buf.insert(buf.end(), s.data, s.data + s.len);
+}
+
+inline void encode_event_batch(std::vector<uint8_t>& buf, const BatchParams& params,
+                               const std::vector<EventParams>& events) {
+    encode_nested_batch<EventEntries>(buf, params, events);
+}
+
+inline void encode_log_batch(std::vector<uint8_t>& buf, const BatchParams& params,
+                             const std::vector<LogEntryParams>& logs) {
+    encode_nested_batch<LogEntries>(buf, params, logs);
+}
+
+inline void encode_event_tables_batch(std::vector<uint8_t>& buf, const BatchParams& params,
+                                      const std::vector<EncodedTable>& tables) {
+    encode_nested_batch<TableEntries>(buf, params, tables);
+}
+
 } // namespace encoding
 } // namespace tell
@@ -0,0 +1,109 @@
+// src/linger.hpp
+// Adaptive linger — picks the worker's flush point from arrival rate and send cost.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+namespace tell {
+
+// Decides when the worker should flush pending records.
+//
+// The target batch is the smallest one that keeps sending under
+// SEND_BUDGET of the worker's time at the measured rate:
+//     target = clamp(rate * send_cost / SEND_BUDGET, min_batch, max_batch)
+// and the linger is how long that batch takes to arrive (target / rate),
+// capped at max_latency. At low traffic the target collapses to min_batch
+// and records go out almost immediately; at high traffic batches grow
+// until each send is amortized.
+//
+// Not thread-safe: owned and driven by the worker thread only.
+class AdaptiveLinger {
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr double SEND_BUDGET = 0.1;                // fraction of time spent sending
+    static constexpr double SMOOTHING = 0.2;                  // EWMA weight of a new sample
+    static constexpr auto RATE_WINDOW = std::chrono::milliseconds(10);
+
+    AdaptiveLinger(std::chrono::milliseconds max_latency, size_t min_batch, size_t max_batch)
+        : max_latency_(max_latency),
+          min_batch_(std::max<size_t>(min_batch, 1)),
+          max_batch_(std::max(max_batch, min_batch_)) {}
+
+    // n records became pending at `now`.
+    void on_arrival(clock::time_point now, size_t n) {
+        if (n == 0) return;
+        if (pending_ == 0) oldest_ = now;
+        pending_ += n;
+
+        if (window_start_ == clock::time_point{}) window_start_ = now;
+        window_arrivals_ += n;
+        if (now - window_start_ >= RATE_WINDOW) {
+            double elapsed = std::chrono::duration<double>(now - window_start_).count();
+            double sample = static_cast<double>(window_arrivals_) / elapsed;
+            rate_ = rate_ == 0.0 ? sample : rate_ + SMOOTHING * (sample - rate_);
+            window_start_ = now;
+            window_arrivals_ = 0;
+        }
+    }
+
+    // One frame took `cost` to send.
+    void on_send(std::chrono::nanoseconds cost) {
+        double seconds = std::chrono::duration<double>(cost).count();
+        send_cost_ += SMOOTHING * (seconds - send_cost_);
+    }
+
+    // n pending records were flushed at `now`. Whatever is left arrived
+    // after them, so its wait is counted from now.
+    void on_flush(size_t n, clock::time_point now) {
+        pending_ -= std::min(n, pending_);
+        oldest_ = now;
+    }
+
+    size_t target_batch() const {
+        double target = rate_ * send_cost_ / SEND_BUDGET;
+        if (target <= static_cast<double>(min_batch_)) return min_batch_;
+        if (target >= static_cast<double>(max_batch_)) return max_batch_;
+        return static_cast<size_t>(target);
+    }
+
+    std::chrono::nanoseconds linger() const {
+        if (rate_ <= 0.0) return max_latency_;
+        auto fill = std::chrono::duration<double>(static_cast<double>(target_batch()) / rate_);
+        auto bounded = std::min(fill, std::chrono::duration<double>(max_latency_));
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(bounded);
+    }
+
+    // When the pending records should be flushed (time_point::max() if none).
+    clock::time_point deadline() const {
+        if (pending_ == 0) return clock::time_point::max();
+        if (pending_ < min_batch_) return oldest_ + max_latency_;
+        return oldest_ + linger();
+    }
+
+    bool due(clock::time_point now) const {
+        if (pending_ == 0) return false;
+        return pending_ >= target_batch() || now >= deadline();
+    }
+
+    size_t pending() const noexcept { return pending_; }
+    double rate() const noexcept { return rate_; }
+
+private:
+    std::chrono::milliseconds max_latency_;
+    size_t min_batch_;
+    size_t max_batch_;
+
+    size_t pending_ = 0;
+    clock::time_point oldest_{};
+
+    clock::time_point window_start_{};
+    size_t window_arrivals_ = 0;
+    double rate_ = 0.0;          // records/second (EWMA)
+    double send_cost_ = 50e-6;   // seconds per frame (EWMA), seeded at a loopback send
+};
+
+} // namespace tell
@@ -0,0 +1,167 @@
+// src/lz4.hpp
+// LZ4 block format (compress + safe decompress) — zero external dependencies.
+// Output is standard LZ4 block data, readable by liblz4's LZ4_decompress_safe
+// and Rust lz4_flex::block::decompress.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace tell {
+namespace lz4 {
+
+// Format limits: matches are at least MIN_MATCH bytes, the last match starts
+// at least MF_LIMIT bytes before the end, and the last LAST_LITERALS bytes are
+// always literals.
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MF_LIMIT = 12;
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MAX_OFFSET = 65535;
+
+// Largest possible compressed size of n input bytes (incompressible input).
+constexpr size_t bound(size_t n) { return n + n / 255 + 16; }
+
+// Largest possible decompressed size of n compressed bytes: a length byte
+// adds at most 255 bytes of output.
+constexpr size_t max_decompressed(size_t n) { return n * 255; }
+
+namespace detail {
+
+constexpr unsigned HASH_LOG = 12;
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint32_t hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - HASH_LOG); }
+
+// Length continuation bytes after a saturated token nibble.
+inline uint8_t* put_length(uint8_t* op, size_t len) {
+    for (; len >= 255; len -= 255) *op++ = 255;
+    *op++ = static_cast<uint8_t>(len);
+    return op;
+}
+
+inline uint8_t* put_literals(uint8_t* op, const uint8_t* literals, size_t n, uint8_t match_nibble) {
+    *op++ = static_cast<uint8_t>(((n < 15 ? n : 15) << 4) | match_nibble);
+    if (n >= 15) op = put_length(op, n - 15);
+    if (n > 0) std::memcpy(op, literals, n);
+    return op + n;
+}
+
+// Continuation bytes of a length; false when the input runs out.
+inline bool get_length(const uint8_t*& ip, const uint8_t* end, size_t& len) {
+    uint8_t b;
+    do {
+        if (ip >= end) return false;
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+} // namespace detail
+
+// Compress n bytes into dst, which must hold bound(n) bytes. Returns the
+// compressed size. Greedy single-probe matching over a 4096-entry hash of
+// 4-byte sequences; the scan step grows on incompressible runs.
+inline size_t compress(const uint8_t* src, size_t n, uint8_t* dst) {
+    using namespace detail;
+    uint8_t* op = dst;
+    const uint8_t* anchor = src;
+
+    if (n > MF_LIMIT) {
+        uint32_t table[1u << HASH_LOG] = {};  // position + 1; 0 = empty
+        const uint8_t* match_limit = src + n - MF_LIMIT;
+        const uint8_t* match_end_limit = src + n - LAST_LITERALS;
+        const uint8_t* ip = src;
+        size_t misses = 1u << 6;
+
+        while (ip < match_limit) {
+            uint32_t sequence = read32(ip);
+            uint32_t& slot = table[hash(sequence)];
+            const uint8_t* ref = slot != 0 ? src + slot - 1 : nullptr;
+            slot = static_cast<uint32_t>(ip - src + 1);
+
+            if (!ref || static_cast<size_t>(ip - ref) > MAX_OFFSET || read32(ref) != sequence) {
+                ip += misses++ >> 6;
+                continue;
+            }
+            misses = 1u << 6;
+
+            // Extend backwards over pending literals, then forwards
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) { ip--; ref--; }
+            const uint8_t* end = ip + MIN_MATCH;
+            const uint8_t* from = ref + MIN_MATCH;
+            while (end + 8 <= match_end_limit && read64(end) == read64(from)) { end += 8; from += 8; }
+            while (end < match_end_limit && *end == *from) { end++; from++; }
+
+            size_t match_len = static_cast<size_t>(end - ip) - MIN_MATCH;
+            op = put_literals(op, anchor, static_cast<size_t>(ip - anchor),
+                              static_cast<uint8_t>(match_len < 15 ? match_len : 15));
+            size_t offset = static_cast<size_t>(ip - ref);
+            *op++ = static_cast<uint8_t>(offset);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+            if (match_len >= 15) op = put_length(op, match_len - 15);
+
+            ip = anchor = end;
+            if (ip < match_limit) table[hash(read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src + 1);
+        }
+    }
+
+    op = put_literals(op, anchor, static_cast<size_t>(src + n - anchor), 0);
+    return static_cast<size_t>(op - dst);
+}
+
+// Decompress an LZ4 block that expands to exactly raw_len bytes into dst.
+// Returns false on malformed input; never reads or writes out of bounds.
+inline bool decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_len) {
+    using namespace detail;
+    const uint8_t* ip = src;
+    const uint8_t* end = src + n;
+    uint8_t* op = dst;
+    uint8_t* out_end = dst + raw_len;
+
+    while (ip < end) {
+        uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !get_length(ip, end, literals)) return false;
+        if (literals > static_cast<size_t>(end - ip) || literals > static_cast<size_t>(out_end - op)) return false;
+        if (literals > 0) std::memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == end) break;  // last sequence: literals only
+
+        if (end - ip < 2) return false;
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+
+        size_t match_len = token & 15;
+        if (match_len == 15 && !get_length(ip, end, match_len)) return false;
+        match_len += MIN_MATCH;
+        if (match_len > static_cast<size_t>(out_end - op)) return false;
+
+        // A match may overlap the bytes it produces: copy those byte by byte
+        const uint8_t* from = op - offset;
+        if (offset >= match_len) std::memcpy(op, from, match_len);
+        else for (size_t i = 0; i < match_len; i++) op[i] = from[i];
+        op += match_len;
+    }
+    return op == out_end;
+}
+
+} // namespace lz4
+} // namespace tell
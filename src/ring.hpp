@@ -0,0 +1,113 @@
+// src/ring.hpp
+// Bounded lock-free ring buffer — sequence-numbered slots (Vyukov).
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace tell {
+
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Bounded multi-producer ring used as the worker channel.
+//
+// Each slot carries a sequence number that tells producers and consumers
+// whose turn it is, so a push or pop is one CAS on a cursor plus one
+// release store on the slot — no mutex, no per-message allocation.
+//
+// The worker is the only regular consumer, but producers also pop to evict
+// the oldest message when the ring is full, so dequeue is CAS-claimed too.
+// Slots and cursors are padded to a cache line to avoid false sharing.
+template <typename T>
+class RingBuffer {
+public:
+    // Capacity is at least 2: with one slot, a published sequence (pos + 1)
+    // would read as "free" to the producer claiming pos + 1.
+    explicit RingBuffer(size_t capacity)
+        : capacity_(capacity < 2 ? 2 : capacity),
+          slots_(new Slot[capacity_]) {
+        for (size_t i = 0; i < capacity_; i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~RingBuffer() {
+        T discard;
+        while (try_pop(discard)) {}
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // Move value into the ring. Returns false (value untouched) when full.
+    bool try_push(T&& value) {
+        Slot* slot;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &slots_[pos % capacity_];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        new (slot->storage) T(std::move(value));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Move the oldest value into out. Returns false when empty.
+    bool try_pop(T& out) {
+        Slot* slot;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &slots_[pos % capacity_];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // empty (or the next slot is still being written)
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        T* item = std::launder(reinterpret_cast<T*>(slot->storage));
+        out = std::move(*item);
+        item->~T();
+        slot->sequence.store(pos + capacity_, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate number of queued items (exact when no push/pop is in flight).
+    size_t size() const noexcept {
+        size_t tail = dequeue_pos_.load(std::memory_order_acquire);
+        size_t head = enqueue_pos_.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    size_t capacity() const noexcept { return capacity_; }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<size_t> sequence{0};
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    const size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+};
+
+} // namespace tell
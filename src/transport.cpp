@@ -145,26 +145,54 @@ void TcpTransport::configure_socket(int fd) {
     ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
 }
 
-bool TcpTransport::write_all(const uint8_t* data, size_t len) {
-    size_t sent = 0;
-    while (sent < len) {
-        ssize_t n = ::send(socket_fd_, data + sent, len - sent, MSG_NOSIGNAL);
+// Loops until every byte is out: sendmsg (for MSG_NOSIGNAL, which writev
+// lacks) takes at most MAX_IOV parts and may stop mid-part, so iov is
+// advanced in place.
+bool TcpTransport::write_all(iovec* iov, size_t count) {
+    constexpr size_t MAX_IOV = 1024;  // IOV_MAX on Linux and macOS
+    for (;;) {
+        while (count > 0 && iov->iov_len == 0) {
+            iov++;
+            count--;
+        }
+        if (count == 0) return true;
+
+        struct msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(count < MAX_IOV ? count : MAX_IOV);
+        ssize_t n = ::sendmsg(socket_fd_, &msg, MSG_NOSIGNAL);
         if (n <= 0) {
             close_connection();
             return false;
         }
-        sent += static_cast<size_t>(n);
+
+        size_t sent = static_cast<size_t>(n);
+        while (sent >= iov->iov_len) {
+            sent -= iov->iov_len;
+            iov++;
+            count--;
+            if (count == 0) return true;
+        }
+        iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + sent;
+        iov->iov_len -= sent;
     }
-    return true;
 }
 
 bool TcpTransport::send_frame(const uint8_t* data, size_t len) {
+    iovec part{const_cast<uint8_t*>(data), len};
+    return send_frame(&part, 1);
+}
+
+bool TcpTransport::send_frame(const iovec* parts, size_t count) {
     try {
         ensure_connected();
     } catch (...) {
         return false;
     }
 
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) len += parts[i].iov_len;
+
     // Length prefix (4 bytes, big-endian)
     if (len > UINT32_MAX) return false;
     uint32_t frame_len = static_cast<uint32_t>(len);
@@ -175,9 +203,11 @@ bool TcpTransport::send_frame(const uint8_t* data, size_t len) {
         static_cast<uint8_t>(frame_len),
     };
 
-    if (!write_all(header, 4)) return false;
-    if (!write_all(data, len)) return false;
-    return true;
+    // Prefix and payload go out together
+    iov_.clear();
+    iov_.push_back({header, 4});
+    iov_.insert(iov_.end(), parts, parts + count);
+    return write_all(iov_.data(), iov_.size());
 }
 
 } // namespace tell
@@ -7,6 +7,9 @@
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
+
+#include <sys/uio.h>
 
 namespace tell {
 
@@ -22,6 +25,10 @@ public:
     // Auto-reconnects on failure.
     bool send_frame(const uint8_t* data, size_t len);
 
+    // Same, for a payload in count pieces: written with one sendmsg, no
+    // copy into a contiguous buffer. parts is not modified.
+    bool send_frame(const iovec* parts, size_t count);
+
     void close_connection();
 
     const std::string& endpoint() const noexcept { return endpoint_; }
@@ -31,13 +38,14 @@ private:
     void ensure_connected();
     void connect();
     void configure_socket(int fd);
-    bool write_all(const uint8_t* data, size_t len);
+    bool write_all(iovec* iov, size_t count);
 
     std::string endpoint_;
     std::string host_;
     uint16_t port_ = 0;
     std::chrono::milliseconds timeout_;
     int socket_fd_ = -1;
+    std::vector<iovec> iov_;  // length prefix + parts of the frame being sent
 };
 
 } // namespace tell
@@ -6,6 +6,7 @@
 #include "tell/error.hpp"
 #include <array>
 #include <string>
+#include <string_view>
 
 namespace tell {
 namespace validation {
@@ -38,22 +39,22 @@ inline std::array<uint8_t, 16> validate_and_decode_api_key(const std::string& ap
     return bytes;
 }
 
-inline bool check_user_id(const std::string& user_id) {
+inline bool check_user_id(std::string_view user_id) {
     return !user_id.empty();
 }
 
 // Validate an event name (non-empty, max 256 chars).
-inline bool check_event_name(const std::string& name) {
+inline bool check_event_name(std::string_view name) {
     return !name.empty() && name.size() <= 256;
 }
 
 // Validate a log message (non-empty, max 64KB).
-inline bool check_log_message(const std::string& message) {
+inline bool check_log_message(std::string_view message) {
     return !message.empty() && message.size() <= 65536;
 }
 
 // Validate a service name (max 256 chars; empty is allowed — defaults to "app").
-inline bool check_service_name(const std::string& service) {
+inline bool check_service_name(std::string_view service) {
     return service.size() <= 256;
 }
 
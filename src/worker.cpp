@@ -3,6 +3,7 @@
 
 #include "worker.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <functional>
@@ -10,24 +11,124 @@
 
 namespace tell {
 
-Worker::Worker(TellConfig config)
+namespace {
+
+std::atomic<uint64_t> next_worker_id{1};
+
+// Per-thread list of staging slots, one per worker this thread has used.
+// On thread exit, anything still staged is handed to its (live) worker.
+struct StagingCache {
+    struct Entry {
+        uint64_t worker_id;
+        std::shared_ptr<StagingSlot> slot;
+    };
+    std::vector<Entry> entries;
+
+    ~StagingCache() {
+        for (auto& e : entries) {
+            std::lock_guard<std::mutex> lock(e.slot->mutex);
+            if (e.slot->owner && !e.slot->block.empty()) {
+                e.slot->owner->send_block(std::move(e.slot->block));
+            }
+        }
+    }
+};
+
+thread_local StagingCache staging_cache;
+
+// Approximate memory held by a queued message, for the queue_max_bytes budget.
+size_t message_bytes(const QueuedEvent& e) {
+    return sizeof(QueuedEvent) + e.event_name.size() + e.payload.size() + e.encoded.len;
+}
+
+size_t message_bytes(const QueuedLog& l) {
+    return sizeof(QueuedLog) + l.source.size() + l.service.size() + l.payload.size();
+}
+
+size_t message_bytes(const StagedBlock& blk) {
+    size_t total = sizeof(StagedBlock);
+    for (const auto& e : blk.events) total += message_bytes(e);
+    for (const auto& l : blk.logs) total += message_bytes(l);
+    return total;
+}
+
+// Records a queued message stands for, for drop accounting.
+size_t message_records(const QueuedEvent&) { return 1; }
+size_t message_records(const QueuedLog&) { return 1; }
+size_t message_records(const StagedBlock& blk) { return blk.size(); }
+
+FlushOutcome worse(FlushOutcome a, FlushOutcome b) {
+    return static_cast<uint8_t>(a) >= static_cast<uint8_t>(b) ? a : b;
+}
+
+encoding::LogEntryParams log_params(const QueuedLog& l) {
+    encoding::LogEntryParams p;
+    p.event_type = LogEventType::Log;
+    p.session_id = l.session_id;
+    p.level = l.level;
+    p.timestamp = l.timestamp;
+    if (!l.source.empty()) {
+        p.source = l.source.c_str();
+        p.source_len = l.source.size();
+    }
+    if (!l.service.empty()) {
+        p.service = l.service.c_str();
+        p.service_len = l.service.size();
+    }
+    if (!l.payload.empty()) {
+        p.payload = l.payload.data();
+        p.payload_len = l.payload.size();
+    }
+    return p;
+}
+
+// Packs entries into frames of at most max_frame_bytes (0 = unlimited),
+// counting the Batch and EventData/LogData wrappers.
+class FrameBudget {
+public:
+    explicit FrameBudget(size_t max_frame) : max_(max_frame) {}
+
+    bool fits(size_t entry) const { return max_ == 0 || used_ + entry <= max_; }
+    bool oversized(size_t entry) const { return max_ > 0 && EMPTY + entry > max_; }
+    void add(size_t entry) { used_ += entry; }
+    void reset() { used_ = EMPTY; }
+
+private:
+    static constexpr size_t EMPTY = encoding::BATCH_OVERHEAD + encoding::DATA_OVERHEAD;
+    size_t max_;
+    size_t used_ = EMPTY;
+};
+
+} // namespace
+
+Worker::Worker(TellConfig config, size_t shard, size_t shard_count)
     : config_(std::move(config)),
-      transport_(config_.endpoint(), config_.network_timeout()) {
+      transport_(config_.endpoint(), config_.network_timeout()),
+      events_(config_.queue_capacity()),
+      logs_(config_.queue_capacity()),
+      blocks_(config_.staging_block_size() > 0 ? config_.queue_capacity() : 2),
+      id_(next_worker_id.fetch_add(1, std::memory_order_relaxed)),
+      batch_counter_(shard + 1),
+      batch_step_(shard_count == 0 ? 1 : shard_count) {
+    if (config_.adaptive_linger()) {
+        linger_.emplace(config_.max_latency(), config_.min_batch_size(), config_.batch_size());
+    }
     event_queue_.reserve(config_.batch_size());
     log_queue_.reserve(config_.batch_size());
-    data_buf_.reserve(64 * 1024);
-    batch_buf_.reserve(64 * 1024);
+    frame_.head.reserve(64 * 1024);
 
     thread_ = std::thread(&Worker::run, this);
 }
 
 Worker::~Worker() {
     if (running_.load()) {
-        (void)send_close();  // future ignored; join() ensures completion
+        send_close(nullptr);  // join() below waits for it
     }
     if (thread_.joinable()) {
         thread_.join();
     }
+    // Detach slots registered after close() so thread exits skip this worker
+    drain_staging(true);
     // Join all outstanding retry threads
     std::lock_guard<std::mutex> lock(retry_mutex_);
     for (auto& t : retry_threads_) {
@@ -36,215 +137,786 @@ Worker::~Worker() {
     retry_threads_.clear();
 }
 
-void Worker::enqueue(WorkerMessage msg) {
-    bool was_empty;
+template <typename T>
+void Worker::enqueue(RingBuffer<T>& ring, T msg) {
+    // Counted before running_ is checked: close waits these out before its
+    // last sweep of the rings, so a message is either swept or refused.
+    enqueuing_.fetch_add(1);
+    if (running_.load()) {
+        admit(ring, std::move(msg));
+    } else {
+        note_dropped(message_records(msg));  // closed: never sent
+    }
+    enqueuing_.fetch_sub(1, std::memory_order_release);
+}
+
+template <typename T>
+void Worker::admit(RingBuffer<T>& ring, T msg) {
+    size_t bytes = message_bytes(msg);
+    size_t max_bytes = config_.queue_max_bytes();
+    if (max_bytes > 0 && bytes > max_bytes) { // can never fit
+        note_dropped(message_records(msg));
+        return;
+    }
+
+    switch (config_.queue_policy()) {
+    case QueuePolicy::DropOldest:
+        // Evict until the message fits both the slot and byte budgets. The
+        // byte budget is shared, so once this ring is empty evict from the
+        // others; if it still does not fit, drop the message.
+        while (over_budget(bytes) && (evict_oldest(ring) || evict_any())) {}
+        if (over_budget(bytes)) {
+            note_dropped(message_records(msg));
+            return;
+        }
+        while (!try_push(ring, msg, bytes)) {
+            (void)evict_oldest(ring);
+        }
+        break;
+
+    case QueuePolicy::DropNewest:
+        if (over_budget(bytes) || !try_push(ring, msg, bytes)) {
+            note_dropped(message_records(msg));
+            return;
+        }
+        break;
+
+    case QueuePolicy::Block: {
+        auto deadline = std::chrono::steady_clock::now() + config_.queue_block_timeout();
+        while (over_budget(bytes) || !try_push(ring, msg, bytes)) {
+            // Nothing drains the queue once closed: drop without waiting
+            if (!running_.load(std::memory_order_relaxed) ||
+                std::chrono::steady_clock::now() >= deadline) {
+                note_dropped(message_records(msg));
+                return;
+            }
+            wait_for_space(deadline);
+        }
+        break;
+    }
+
+    case QueuePolicy::Sample:
+        if (!sample_admit(ring, bytes) || !try_push(ring, msg, bytes)) {
+            note_dropped(message_records(msg));
+            return;
+        }
+        break;
+    }
+    wake();
+}
+
+// Drain at most one ring's worth so a busy channel can't starve the timer or
+// control signals. With settle (a signal is pending), wait out slots a producer
+// has claimed but not yet published, so nothing enqueued before the signal is
+// left behind.
+template <typename T, typename Sink>
+void Worker::drain(RingBuffer<T>& ring, bool settle, Sink sink) {
+    T msg;
+    for (size_t n = ring.capacity(); n > 0; n--) {
+        if (!ring.try_pop(msg)) {
+            if (!settle || ring.empty()) break;
+            std::this_thread::yield();
+            continue;
+        }
+        queued_bytes_.fetch_sub(message_bytes(msg), std::memory_order_relaxed);
+        sink(msg);
+    }
+}
+
+void Worker::enqueue_control(ControlSignal signal) {
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        was_empty = queue_.empty();
-        if (queue_.size() >= MAX_QUEUE_SIZE) {
-            // Drop oldest
-            queue_.pop();
+        std::lock_guard<std::mutex> lock(control_mutex_);
+        if (running_.load()) {
+            control_.push_back(std::move(signal));
+            has_control_.store(true, std::memory_order_relaxed);
+            signal.completion = nullptr;
         }
-        queue_.push(std::move(msg));
     }
-    // Only wake the worker if it's likely sleeping (queue was empty)
-    if (was_empty) {
+    // Already closed: answer right away with whatever was dropped since
+    if (auto& done = signal.completion) {
+        FlushResult closed;
+        closed.dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (closed.dropped > 0) closed.outcome = FlushOutcome::Dropped;
+        done(closed);
+        return;
+    }
+    wake();
+}
+
+void Worker::note_dropped(size_t count) {
+    dropped_.fetch_add(count, std::memory_order_relaxed);
+}
+
+void Worker::tally(size_t FlushResult::*counter, size_t count, FlushOutcome outcome) {
+    if (outcome == FlushOutcome::Dropped) {
+        result_.dropped += count;
+    } else {
+        result_.*counter += count;
+    }
+    result_.outcome = worse(result_.outcome, outcome);
+}
+
+// Hand out the tally for a flush/close signal and start a new one.
+FlushResult Worker::take_result() {
+    FlushResult r = result_;
+    result_ = FlushResult{};
+    r.dropped += dropped_.exchange(0, std::memory_order_relaxed);
+    if (r.dropped > 0) r.outcome = FlushOutcome::Dropped;
+    return r;
+}
+
+template <typename T>
+bool Worker::try_push(RingBuffer<T>& ring, T& msg, size_t bytes) {
+    queued_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    if (ring.try_push(std::move(msg))) return true;
+    queued_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    return false;
+}
+
+// Pop and discard the oldest message. False if the ring is (momentarily) empty.
+template <typename T>
+bool Worker::evict_oldest(RingBuffer<T>& ring) {
+    T dropped;
+    if (!ring.try_pop(dropped)) return false;
+    queued_bytes_.fetch_sub(message_bytes(dropped), std::memory_order_relaxed);
+    note_dropped(message_records(dropped));
+    return true;
+}
+
+// Evict the oldest message of whichever ring still holds one.
+bool Worker::evict_any() {
+    return evict_oldest(events_) || evict_oldest(logs_) || evict_oldest(blocks_);
+}
+
+// Bulk-lane logs (Debug/Trace by default) are dropped once the channel is half
+// full, by count or bytes, so they give way before anything else is shed. With
+// staging on, logs travel in staged blocks, so that ring counts as well.
+bool Worker::shed_bulk(size_t bytes) const {
+    if (logs_.size() * 2 >= logs_.capacity() || blocks_.size() * 2 >= blocks_.capacity()) return true;
+    size_t max_bytes = config_.queue_max_bytes();
+    return max_bytes > 0 && (queued_bytes_.load(std::memory_order_relaxed) + bytes) * 2 > max_bytes;
+}
+
+bool Worker::over_budget(size_t bytes) const {
+    size_t max_bytes = config_.queue_max_bytes();
+    return max_bytes > 0 && queued_bytes_.load(std::memory_order_relaxed) + bytes > max_bytes;
+}
+
+// Below half capacity everything is admitted; above it, the admit probability
+// falls linearly to zero at full (by message count or bytes, whichever is fuller).
+template <typename T>
+bool Worker::sample_admit(const RingBuffer<T>& ring, size_t bytes) const {
+    double fill = static_cast<double>(ring.size()) / static_cast<double>(ring.capacity());
+    size_t max_bytes = config_.queue_max_bytes();
+    if (max_bytes > 0) {
+        double byte_fill = static_cast<double>(queued_bytes_.load(std::memory_order_relaxed) + bytes) /
+                           static_cast<double>(max_bytes);
+        fill = std::max(fill, byte_fill);
+    }
+    if (fill < 0.5) return true;
+    if (fill >= 1.0) return false;
+
+    static thread_local std::minstd_rand rng(std::random_device{}());
+    double keep = (1.0 - fill) * 2.0;
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < keep;
+}
+
+// Park a QueuePolicy::Block producer until the worker drains, closes or the
+// deadline passes. Short slices make a missed notify cost at most 1ms; close
+// clears running_ before notifying under space_mutex_, so it is never missed.
+void Worker::wait_for_space(std::chrono::steady_clock::time_point deadline) {
+    blocked_producers_.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(space_mutex_);
+        auto slice = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+        if (running_.load()) space_cv_.wait_until(lock, std::min(deadline, slice));
+    }
+    blocked_producers_.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+// Only take the mutex if the worker is (about to be) parked. The fence pairs
+// with the one in run(): either we see sleeping_ or the worker sees our push.
+void Worker::wake() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex_);
         cv_.notify_one();
     }
 }
 
 void Worker::send_event(QueuedEvent event) {
-    enqueue(std::move(event));
+    if (config_.encode_on_producer()) {
+        // Runs on the calling thread: encode the table into this thread's
+        // arena and drop the now-redundant owned fields.
+        event.encoded = ProducerArena::local().encode_event(event_params(event));
+        event.event_name = std::string();
+        event.payload = std::vector<uint8_t>();
+    }
+
+    if (stage(event, &StagedBlock::events)) return;
+    enqueue(events_, std::move(event));
 }
 
 void Worker::send_log(QueuedLog log) {
-    enqueue(std::move(log));
+    if (!running_.load(std::memory_order_relaxed)) { // closed: never sent
+        note_dropped();
+        return;
+    }
+    // Lower value = more severe
+    if (log.level <= config_.priority_log_level()) {
+        {
+            // Rechecked under the lock: close() sweeps priority_ after
+            // clearing running_, so a log is either swept or refused here.
+            std::lock_guard<std::mutex> lock(priority_mutex_);
+            if (!running_.load(std::memory_order_relaxed)) {
+                note_dropped();
+                return;
+            }
+            // Bounded like a data channel: up to queue_capacity logs, and
+            // their bytes count against the shared budget. Within that the
+            // lane is never shed.
+            size_t bytes = message_bytes(log);
+            if (priority_.size() >= config_.queue_capacity() || over_budget(bytes)) {
+                note_dropped();
+                return;
+            }
+            queued_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+            priority_.push_back(std::move(log));
+            has_priority_.store(true, std::memory_order_relaxed);
+        }
+        wake();
+        return;
+    }
+    if (log.level >= config_.bulk_log_level() &&
+        shed_bulk(message_bytes(log))) {
+        note_dropped();
+        return;
+    }
+
+    if (stage(log, &StagedBlock::logs)) return;
+    enqueue(logs_, std::move(log));
+}
+
+void Worker::send_block(StagedBlock block) {
+    enqueue(blocks_, std::move(block));
 }
 
-std::future<void> Worker::send_flush() {
-    auto p = std::make_shared<std::promise<void>>();
-    auto f = p->get_future();
-    enqueue(FlushSignal{std::move(p)});
-    return f;
+// Append a record to this thread's staging block, handing the block off once
+// full. False when staging is off or the worker has closed: the caller then
+// enqueues, which counts the record as dropped after close.
+template <typename T>
+bool Worker::stage(T& record, std::vector<T> StagedBlock::*lane) {
+    size_t block_size = config_.staging_block_size();
+    if (block_size == 0) return false;
+    StagingSlot* slot = local_slot();
+    if (!slot) return false;
+
+    StagedBlock full;
+    {
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        if (!slot->owner) return false;  // detached by a racing close()
+        (slot->block.*lane).push_back(std::move(record));
+        if (slot->block.size() < block_size) return true;
+        std::swap(full, slot->block);
+    }
+    send_block(std::move(full));
+    return true;
 }
 
-std::future<void> Worker::send_close() {
-    auto p = std::make_shared<std::promise<void>>();
-    auto f = p->get_future();
-    enqueue(CloseSignal{std::move(p)});
-    return f;
+// Find (or register) this thread's staging slot. Returns nullptr once the
+// worker is closed, so late calls fall through to the channel like before.
+StagingSlot* Worker::local_slot() {
+    auto& entries = staging_cache.entries;
+    for (auto& e : entries) {
+        if (e.worker_id != id_) continue;
+        // A slot detached by close() must not take records: they would be
+        // discarded at thread exit without being counted.
+        if (e.slot->detached.load(std::memory_order_relaxed)) break;
+        return e.slot.get();
+    }
+
+    auto slot = std::make_shared<StagingSlot>();
+    slot->owner = this;
+    slot->block.events.reserve(config_.staging_block_size());
+    {
+        std::lock_guard<std::mutex> lock(staging_mutex_);
+        if (staging_closed_) return nullptr;
+        staging_slots_.push_back(slot);
+    }
+
+    // Prune slots of closed workers before adding ours
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+        [](const StagingCache::Entry& e) { return e.slot->detached.load(std::memory_order_relaxed); }),
+        entries.end());
+    entries.push_back({id_, std::move(slot)});
+    return entries.back().slot.get();
+}
+
+// Publish every thread's staged block into the channel (flush/close path).
+// With detach, slots are disowned and no new ones can register.
+void Worker::drain_staging(bool detach) {
+    std::lock_guard<std::mutex> reg(staging_mutex_);
+    if (detach) staging_closed_ = true;
+
+    for (auto& slot : staging_slots_) {
+        StagedBlock block;
+        {
+            std::lock_guard<std::mutex> lock(slot->mutex);
+            std::swap(block, slot->block);
+            if (detach) {
+                slot->owner = nullptr;
+                slot->detached.store(true, std::memory_order_relaxed);
+            }
+        }
+        if (!block.empty()) send_block(std::move(block));
+    }
+
+    if (detach) {
+        staging_slots_.clear();
+    } else {
+        // Threads that exited already published; only our reference remains.
+        staging_slots_.erase(std::remove_if(staging_slots_.begin(), staging_slots_.end(),
+            [](const std::shared_ptr<StagingSlot>& s) { return s.use_count() == 1; }),
+            staging_slots_.end());
+    }
+}
+
+// Worker-side pickup of staged records at the flush_interval deadline, so an
+// idle producer thread can't hold events back indefinitely.
+void Worker::collect_staged() {
+    // try_lock only: a producer holding its slot (or the registry) may itself be
+    // waiting on this thread to drain under QueuePolicy::Block.
+    std::unique_lock<std::mutex> reg(staging_mutex_, std::try_to_lock);
+    if (!reg) return;
+    for (auto& slot : staging_slots_) {
+        StagedBlock block;
+        {
+            std::unique_lock<std::mutex> lock(slot->mutex, std::try_to_lock);
+            if (!lock) continue;
+            std::swap(block, slot->block);
+        }
+        for (auto& e : block.events) add_event(std::move(e));
+        for (auto& l : block.logs) add_log(std::move(l));
+    }
+}
+
+void Worker::send_flush(FlushCallback done) {
+    if (config_.staging_block_size() > 0) drain_staging(false);
+    enqueue_control({ControlSignal::Kind::Flush, std::move(done)});
+}
+
+void Worker::send_close(FlushCallback done) {
+    if (config_.staging_block_size() > 0) drain_staging(true);
+    enqueue_control({ControlSignal::Kind::Close, std::move(done)});
 }
 
 void Worker::run() {
     auto flush_interval = config_.flush_interval();
-    auto batch_size = config_.batch_size();
     auto next_flush = std::chrono::steady_clock::now() + flush_interval;
 
     while (running_.load()) {
-        std::unique_lock<std::mutex> lock(mutex_);
-
-        auto wait_until = next_flush;
-        cv_.wait_until(lock, wait_until, [this] { return !queue_.empty() || !running_.load(); });
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto wake_at = linger_ ? std::min(next_flush, linger_->deadline()) : next_flush;
+            cv_.wait_until(lock, wake_at, [this] {
+                return !events_.empty() || !logs_.empty() || !blocks_.empty() ||
+                       has_control_.load(std::memory_order_relaxed) ||
+                       has_priority_.load(std::memory_order_relaxed) || !running_.load();
+            });
+            sleeping_.store(false, std::memory_order_relaxed);
+        }
 
-        // Drain all pending messages
-        std::queue<WorkerMessage> local_queue;
-        std::swap(local_queue, queue_);
-        lock.unlock();
+        // Take control signals before draining: everything enqueued before a
+        // flush()/close() call is then in the ring ahead of our drain.
+        std::vector<ControlSignal> control;
+        if (has_control_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(control_mutex_);
+            std::swap(control, control_);
+            has_control_.store(false, std::memory_order_relaxed);
+        }
 
         bool should_flush = false;
         bool should_close = false;
-        std::vector<std::shared_ptr<std::promise<void>>> completions;
-
-        while (!local_queue.empty()) {
-            auto& msg = local_queue.front();
-            if (auto* ev = std::get_if<QueuedEvent>(&msg)) {
-                event_queue_.push_back(std::move(*ev));
-                if (event_queue_.size() >= batch_size) {
-                    flush_events();
-                }
-            } else if (auto* lg = std::get_if<QueuedLog>(&msg)) {
-                log_queue_.push_back(std::move(*lg));
-                if (log_queue_.size() >= batch_size) {
-                    flush_logs();
-                }
-            } else if (auto* fs = std::get_if<FlushSignal>(&msg)) {
-                should_flush = true;
-                if (fs->completion) completions.push_back(std::move(fs->completion));
-            } else if (auto* cs = std::get_if<CloseSignal>(&msg)) {
+        std::vector<FlushCallback> completions;
+        for (auto& c : control) {
+            if (c.kind == ControlSignal::Kind::Close) {
                 should_close = true;
-                if (cs->completion) completions.push_back(std::move(cs->completion));
+            } else {
+                should_flush = true;
             }
-            local_queue.pop();
+            if (c.completion) completions.push_back(std::move(c.completion));
+        }
+
+        // High lane goes out first, as its own batch, without waiting for
+        // batch_size or the timer.
+        flush_priority_logs();
+
+        bool settle = !control.empty();
+        drain(events_, settle, [this](QueuedEvent& e) { add_event(std::move(e)); });
+        drain(logs_, settle, [this](QueuedLog& l) { add_log(std::move(l)); });
+        drain(blocks_, settle, [this](StagedBlock& blk) {
+            for (auto& e : blk.events) add_event(std::move(e));
+            for (auto& l : blk.logs) add_log(std::move(l));
+        });
+
+        if (blocked_producers_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(space_mutex_);
+            space_cv_.notify_all();
         }
 
         // Timer-based flush
         auto now = std::chrono::steady_clock::now();
         if (now >= next_flush) {
+            collect_staged();
             should_flush = true;
             next_flush = now + flush_interval;
         }
 
-        if (should_flush || should_close) {
+        // Adaptive flush point: full target batch or linger deadline reached
+        bool linger_due = false;
+        if (linger_) {
+            linger_->on_arrival(now, arrivals_);
+            arrivals_ = 0;
+            linger_due = linger_->due(now);
+        }
+
+        if (linger_due || should_flush || should_close) {
             flush_events();
             flush_logs();
-
-            for (auto& p : completions) {
-                p->set_value();
-            }
-            completions.clear();
         }
 
         if (should_close) {
             transport_.close_connection();
+            // Stop accepting before answering, so anything sent after close()
+            // returns counts as dropped. Signals that raced with close still
+            // get an answer.
+            std::lock_guard<std::mutex> lock(control_mutex_);
             running_.store(false);
-            return;
+            {
+                // Producers parked by QueuePolicy::Block drop right away
+                std::lock_guard<std::mutex> space_lock(space_mutex_);
+                space_cv_.notify_all();
+            }
+            for (auto& c : control_) {
+                if (c.completion) completions.push_back(std::move(c.completion));
+            }
+            control_.clear();
+            has_control_.store(false, std::memory_order_relaxed);
+
+            // High-lane logs that raced in after the last send
+            std::lock_guard<std::mutex> priority_lock(priority_mutex_);
+            result_.dropped += priority_.size();
+            for (const auto& l : priority_) {
+                queued_bytes_.fetch_sub(message_bytes(l), std::memory_order_relaxed);
+            }
+            priority_.clear();
+            has_priority_.store(false, std::memory_order_relaxed);
         }
+
+        if (should_close) {
+            // Producers that passed the running_ check before it cleared
+            // finish their push first; whatever they left in the rings after
+            // the last drain was never sent.
+            while (enqueuing_.load() > 0) std::this_thread::yield();
+            auto dropped = [this](auto& msg) { result_.dropped += message_records(msg); };
+            drain(events_, true, dropped);
+            drain(logs_, true, dropped);
+            drain(blocks_, true, dropped);
+        }
+
+        if (!completions.empty()) {
+            FlushResult result = take_result();
+            for (auto& done : completions) done(result);
+            completions.clear();
+        }
+
+        if (should_close) return;
+    }
+}
+
+const std::string& Worker::resolved_service() const {
+    static const std::string default_service = "app";
+    const auto& svc = config_.service();
+    return svc.empty() ? default_service : svc;
+}
+
+encoding::EventParams Worker::event_params(const QueuedEvent& e) const {
+    const auto& svc = resolved_service();
+    encoding::EventParams p;
+    p.event_type = e.event_type;
+    p.timestamp = e.timestamp;
+    p.service = svc.c_str();
+    p.service_len = svc.size();
+    p.device_id = e.device_id;
+    p.session_id = e.session_id;
+    if (!e.event_name.empty()) {
+        p.event_name = e.event_name.c_str();
+        p.event_name_len = e.event_name.size();
+    }
+    if (!e.payload.empty()) {
+        p.payload = e.payload.data();
+        p.payload_len = e.payload.size();
+    }
+    return p;
+}
+
+// Accumulate, flushing on batch_size or max_batch_bytes, whichever comes first.
+void Worker::add_event(QueuedEvent event) {
+    size_t size = event.encoded ? event.encoded.len : encoding::encoded_event_size(event_params(event));
+    event_bytes_ += encoding::data_entry_size(size);
+    event_queue_.push_back(std::move(event));
+    arrivals_++;
+
+    size_t max_bytes = config_.max_batch_bytes();
+    if (event_queue_.size() >= config_.batch_size() || (max_bytes > 0 && event_bytes_ >= max_bytes)) {
+        flush_events();
+    }
+}
+
+void Worker::add_log(QueuedLog log) {
+    log_bytes_ += encoding::data_entry_size(encoding::encoded_log_entry_size(log_params(log)));
+    log_queue_.push_back(std::move(log));
+    arrivals_++;
+
+    size_t max_bytes = config_.max_batch_bytes();
+    if (log_queue_.size() >= config_.batch_size() || (max_bytes > 0 && log_bytes_ >= max_bytes)) {
+        flush_logs();
+    }
+}
+
+void Worker::report_oversized(size_t entry_size) {
+    result_.dropped++;
+    if (config_.on_error()) {
+        config_.on_error()(TellError::serialization("record of " + std::to_string(entry_size) +
+            " bytes exceeds max_frame_bytes, dropped"));
     }
 }
 
+// Tell the linger a flush took n records, including flushes triggered by
+// batch_size/max_batch_bytes while draining.
+void Worker::linger_flushed(size_t n) {
+    if (!linger_) return;
+    auto now = std::chrono::steady_clock::now();
+    linger_->on_arrival(now, arrivals_);
+    arrivals_ = 0;
+    linger_->on_flush(n, now);
+}
+
 void Worker::flush_events() {
     if (event_queue_.empty()) return;
+    event_bytes_ = 0;
+    linger_flushed(event_queue_.size());
+    if (config_.encode_on_producer()) {
+        flush_encoded_events();
+        return;
+    }
 
     std::vector<QueuedEvent> events;
     std::swap(events, event_queue_);
 
-    // Build encoding params
+    // Build encoding params, split into frames of at most max_frame_bytes
     std::vector<encoding::EventParams> params;
     params.reserve(events.size());
 
-    const auto& svc = config_.service();
-    static const std::string default_service = "app";
-    const auto& resolved_svc = svc.empty() ? default_service : svc;
+    FrameBudget budget(config_.max_frame_bytes());
     for (const auto& e : events) {
-        encoding::EventParams p;
-        p.event_type = e.event_type;
-        p.timestamp = e.timestamp;
-        p.service = resolved_svc.c_str();
-        p.service_len = resolved_svc.size();
-        p.device_id = e.device_id;
-        p.session_id = e.session_id;
-        if (!e.event_name.empty()) {
-            p.event_name = e.event_name.c_str();
-            p.event_name_len = e.event_name.size();
+        auto p = event_params(e);
+        size_t entry = encoding::data_entry_size(encoding::encoded_event_size(p));
+        if (budget.oversized(entry)) {
+            report_oversized(entry);
+            continue;
         }
-        if (!e.payload.empty()) {
-            p.payload = e.payload.data();
-            p.payload_len = e.payload.size();
+        if (!budget.fits(entry)) {
+            send_event_params(params);
+            params.clear();
+            budget.reset();
         }
         params.push_back(p);
+        budget.add(entry);
     }
+    send_event_params(params);
+}
 
-    // Encode EventData
-    data_buf_.clear();
-    size_t data_start = encoding::encode_event_data_into(data_buf_, params);
+void Worker::send_event_params(const std::vector<encoding::EventParams>& params) {
+    if (params.empty()) return;
 
-    // Encode Batch
-    batch_buf_.clear();
-    encoding::BatchParams bp;
-    bp.api_key = config_.api_key_bytes().data();
-    bp.schema_type = SchemaType::Event;
-    bp.version = encoding::DEFAULT_VERSION;
-    bp.batch_id = batch_counter_.fetch_add(1, std::memory_order_relaxed);
-    bp.data = data_buf_.data() + data_start;
-    bp.data_len = data_buf_.size() - data_start;
-    encoding::encode_batch_into(batch_buf_, bp);
+    if (compressing()) {
+        data_buf_.clear();
+        encoding::encode_event_data_exact(data_buf_, params);
+        tally(&FlushResult::events, params.size(), send_data(SchemaType::Event));
+        return;
+    }
+
+    // Headers and tables are encoded into frame_.head; large payloads are
+    // sent straight from the queued events
+    encoding::gather_event_batch(frame_, batch_header(SchemaType::Event), params);
+
+    tally(&FlushResult::events, params.size(), send_or_retry(frame_));
+}
+
+// Encode-on-producer: event tables are already encoded in producer arenas,
+// so only the EventData offsets vector and the Batch header are built here.
+void Worker::flush_encoded_events() {
+    std::vector<QueuedEvent> events;
+    std::swap(events, event_queue_);
+
+    std::vector<encoding::EncodedTable> tables;
+    tables.reserve(events.size());
+
+    FrameBudget budget(config_.max_frame_bytes());
+    for (const auto& e : events) {
+        size_t entry = encoding::data_entry_size(e.encoded.len);
+        if (budget.oversized(entry)) {
+            report_oversized(entry);
+            continue;
+        }
+        if (!budget.fits(entry)) {
+            send_event_tables(tables);
+            tables.clear();
+            budget.reset();
+        }
+        tables.push_back({e.encoded.data, e.encoded.len});
+        budget.add(entry);
+    }
+    send_event_tables(tables);
+}
+
+void Worker::send_event_tables(const std::vector<encoding::EncodedTable>& tables) {
+    if (tables.empty()) return;
+
+    if (compressing()) {
+        data_buf_.clear();
+        encoding::encode_data_exact<encoding::TableEntries>(data_buf_, tables);
+        tally(&FlushResult::events, tables.size(), send_data(SchemaType::Event));
+        return;
+    }
+
+    // Large tables are sent straight from the producer arenas
+    encoding::gather_event_tables_batch(frame_, batch_header(SchemaType::Event), tables);
 
-    send_or_retry(batch_buf_.data(), batch_buf_.size());
+    tally(&FlushResult::events, tables.size(), send_or_retry(frame_));
 }
 
 void Worker::flush_logs() {
     if (log_queue_.empty()) return;
 
+    log_bytes_ = 0;
+    linger_flushed(log_queue_.size());
+
     std::vector<QueuedLog> logs;
     std::swap(logs, log_queue_);
+    send_logs(logs);
+}
+
+// Taken after control signals, so high-lane logs sent before a flush()/close()
+// go out with it.
+void Worker::flush_priority_logs() {
+    if (!has_priority_.load(std::memory_order_relaxed)) return;
+    {
+        std::lock_guard<std::mutex> lock(priority_mutex_);
+        std::swap(priority_queue_, priority_);
+        has_priority_.store(false, std::memory_order_relaxed);
+    }
+    for (const auto& l : priority_queue_) {
+        queued_bytes_.fetch_sub(message_bytes(l), std::memory_order_relaxed);
+    }
+    send_logs(priority_queue_);
+    priority_queue_.clear();
+}
+
+void Worker::send_logs(std::vector<QueuedLog>& logs) {
+    if (logs.empty()) return;
 
     std::vector<encoding::LogEntryParams> params;
     params.reserve(logs.size());
 
+    FrameBudget budget(config_.max_frame_bytes());
     for (const auto& l : logs) {
-        encoding::LogEntryParams p;
-        p.event_type = LogEventType::Log;
-        p.session_id = l.session_id;
-        p.level = l.level;
-        p.timestamp = l.timestamp;
-        if (!l.source.empty()) {
-            p.source = l.source.c_str();
-            p.source_len = l.source.size();
+        auto p = log_params(l);
+        size_t entry = encoding::data_entry_size(encoding::encoded_log_entry_size(p));
+        if (budget.oversized(entry)) {
+            report_oversized(entry);
+            continue;
         }
-        if (!l.service.empty()) {
-            p.service = l.service.c_str();
-            p.service_len = l.service.size();
-        }
-        if (!l.payload.empty()) {
-            p.payload = l.payload.data();
-            p.payload_len = l.payload.size();
+        if (!budget.fits(entry)) {
+            send_log_params(params);
+            params.clear();
+            budget.reset();
         }
         params.push_back(p);
+        budget.add(entry);
+    }
+    send_log_params(params);
+}
+
+void Worker::send_log_params(const std::vector<encoding::LogEntryParams>& params) {
+    if (params.empty()) return;
+
+    if (compressing()) {
+        data_buf_.clear();
+        encoding::encode_log_data_exact(data_buf_, params);
+        tally(&FlushResult::logs, params.size(), send_data(SchemaType::Log));
+        return;
     }
 
-    data_buf_.clear();
-    size_t data_start = encoding::encode_log_data_into(data_buf_, params);
+    encoding::gather_log_batch(frame_, batch_header(SchemaType::Log), params);
+
+    tally(&FlushResult::logs, params.size(), send_or_retry(frame_));
+}
 
-    batch_buf_.clear();
+encoding::BatchParams Worker::batch_header(SchemaType schema) {
     encoding::BatchParams bp;
     bp.api_key = config_.api_key_bytes().data();
-    bp.schema_type = SchemaType::Log;
+    bp.schema_type = schema;
     bp.version = encoding::DEFAULT_VERSION;
-    bp.batch_id = batch_counter_.fetch_add(1, std::memory_order_relaxed);
-    bp.data = data_buf_.data() + data_start;
-    bp.data_len = data_buf_.size() - data_start;
-    encoding::encode_batch_into(batch_buf_, bp);
+    bp.batch_id = batch_counter_.fetch_add(batch_step_, std::memory_order_relaxed);
+    return bp;
+}
 
-    send_or_retry(batch_buf_.data(), batch_buf_.size());
+bool Worker::compressing() const {
+    return config_.compression() != Compression::None;
 }
 
-void Worker::send_or_retry(const uint8_t* data, size_t len) {
-    if (transport_.send_frame(data, len)) {
-        return; // Fast path: sent on first try
+// Compressed frames need the data contiguous, so EventData/LogData is encoded
+// into data_buf_ first; small batches go out from there uncompressed.
+FlushOutcome Worker::send_data(SchemaType schema) {
+    encoding::BatchParams header = batch_header(schema);
+    header.data = data_buf_.data();
+    header.data_len = data_buf_.size();
+
+    frame_.clear();
+    if (data_buf_.size() >= config_.compression_min_bytes()) {
+        encoding::encode_compressed_batch(frame_.head, header, config_.compression());
+    } else {
+        encoding::encode_batch_exact(frame_.head, header);
+    }
+    frame_.segments.push_back({frame_.head.data(), frame_.head.size()});
+    return send_or_retry(frame_);
+}
+
+FlushOutcome Worker::send_or_retry(const encoding::GatherFrame& frame) {
+    iov_.clear();
+    for (const auto& s : frame.segments) {
+        iov_.push_back({const_cast<uint8_t*>(s.data), s.len});
+    }
+
+    bool sent;
+    if (linger_) {
+        auto start = std::chrono::steady_clock::now();
+        sent = transport_.send_frame(iov_.data(), iov_.size());
+        linger_->on_send(std::chrono::steady_clock::now() - start);
+    } else {
+        sent = transport_.send_frame(iov_.data(), iov_.size());
+    }
+    if (sent) {
+        return FlushOutcome::Sent; // Fast path: sent on first try
     }
 
     if (config_.max_retries() > 0) {
-        std::vector<uint8_t> owned(data, data + len);
+        // The frame points into queued payloads, which are freed after this flush
+        std::vector<uint8_t> owned = frame.flatten();
         std::lock_guard<std::mutex> lock(retry_mutex_);
         // Reap finished threads before checking limit
         retry_threads_.erase(
@@ -261,12 +933,15 @@ void Worker::send_or_retry(const uint8_t* data, size_t len) {
             if (config_.on_error()) {
                 config_.on_error()(TellError::network("send failed, retry pool full"));
             }
-        } else {
-            retry_threads_.emplace_back(&Worker::retry_send, this, std::move(owned));
+            return FlushOutcome::Dropped;
         }
-    } else if (config_.on_error()) {
+        retry_threads_.emplace_back(&Worker::retry_send, this, std::move(owned));
+        return FlushOutcome::QueuedForRetry;
+    }
+    if (config_.on_error()) {
         config_.on_error()(TellError::network("send failed, no retries configured"));
     }
+    return FlushOutcome::Dropped;
 }
 
 void Worker::retry_send(std::vector<uint8_t> data) {
@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include "arena.hpp"
 #include "encoding.hpp"
+#include "linger.hpp"
+#include "ring.hpp"
 #include "transport.hpp"
+#include "tell/client.hpp"
 #include "tell/config.hpp"
 #include "tell/error.hpp"
 #include "tell/types.hpp"
@@ -17,10 +21,9 @@
 #include <future>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
 #include <string>
 #include <thread>
-#include <variant>
 #include <vector>
 
 namespace tell {
@@ -35,6 +38,10 @@ struct QueuedEvent {
     std::vector<uint8_t> payload;
     // Note: service is set at config level, not per-event.
     // The worker reads it from config_ when building EventParams.
+
+    // Set in encode-on-producer mode: the finished event table. The fields
+    // above are then already encoded and payload/event_name are released.
+    ArenaSlice encoded;
 };
 
 // Queued log entry ready to be encoded.
@@ -47,20 +54,40 @@ struct QueuedLog {
     std::vector<uint8_t> payload;
 };
 
-// Signals carry a per-request completion promise (like Rust's oneshot channel).
-struct FlushSignal {
-    std::shared_ptr<std::promise<void>> completion;
+// Events and logs staged by one producer thread, handed off as one message.
+struct StagedBlock {
+    std::vector<QueuedEvent> events;
+    std::vector<QueuedLog> logs;
+
+    bool empty() const noexcept { return events.empty() && logs.empty(); }
+    size_t size() const noexcept { return events.size() + logs.size(); }
 };
-struct CloseSignal {
-    std::shared_ptr<std::promise<void>> completion;
+
+class Worker;
+
+// One producer thread's staging area for one worker. Shared by the thread's
+// cache and the worker's registry; the worker clears owner on close so a
+// late thread exit never publishes into a dead worker.
+struct StagingSlot {
+    std::mutex mutex;
+    Worker* owner = nullptr;            // guarded by mutex
+    std::atomic<bool> detached{false};  // owner cleared (lets caches prune)
+    StagedBlock block;                  // guarded by mutex
 };
 
-// Worker message: exactly one variant active at a time.
-using WorkerMessage = std::variant<QueuedEvent, QueuedLog, FlushSignal, CloseSignal>;
+// Flush/close request: travels out of band and is never dropped. Carries a
+// per-request completion callback (like Rust's oneshot channel).
+struct ControlSignal {
+    enum class Kind : uint8_t { Flush, Close };
+    Kind kind = Kind::Flush;
+    FlushCallback completion;
+};
 
 class Worker {
 public:
-    Worker(TellConfig config);
+    // shard/shard_count: position in a sharded pipeline (config.workers()).
+    // Batch ids are interleaved across shards so they stay unique.
+    Worker(TellConfig config, size_t shard = 0, size_t shard_count = 1);
     ~Worker();
 
     Worker(const Worker&) = delete;
@@ -69,41 +96,125 @@ public:
     // Send a message to the worker (non-blocking).
     void send_event(QueuedEvent event);
     void send_log(QueuedLog log);
-    std::future<void> send_flush();
-    std::future<void> send_close();
+    void send_block(StagedBlock block);
+    // done runs on the worker thread with the result since the previous
+    // signal (or right away, as Dropped, if the worker has already closed).
+    void send_flush(FlushCallback done);
+    void send_close(FlushCallback done);
 
     // Access config (for service resolution in client).
     const TellConfig& config() const noexcept { return config_; }
 
 private:
     void run();
+    void add_event(QueuedEvent event);
+    void add_log(QueuedLog log);
     void flush_events();
+    void flush_encoded_events();
+    void send_event_params(const std::vector<encoding::EventParams>& params);
+    void send_event_tables(const std::vector<encoding::EncodedTable>& tables);
+    const std::string& resolved_service() const;
+    encoding::EventParams event_params(const QueuedEvent& e) const;
     void flush_logs();
-    void send_or_retry(const uint8_t* data, size_t len);
+    void flush_priority_logs();
+    void send_logs(std::vector<QueuedLog>& logs);
+    void send_log_params(const std::vector<encoding::LogEntryParams>& params);
+    void report_oversized(size_t entry_size);
+    void linger_flushed(size_t n);
+    encoding::BatchParams batch_header(SchemaType schema);
+    bool compressing() const;
+    FlushOutcome send_data(SchemaType schema);
+    FlushOutcome send_or_retry(const encoding::GatherFrame& frame);
+    void tally(size_t FlushResult::*counter, size_t count, FlushOutcome outcome);
+    FlushResult take_result();
+    void note_dropped(size_t count = 1);
     void retry_send(std::vector<uint8_t> data);
 
-    void enqueue(WorkerMessage msg);
+    // Data channels are typed; each applies the configured QueuePolicy.
+    template <typename T> void enqueue(RingBuffer<T>& ring, T msg);
+    template <typename T> void admit(RingBuffer<T>& ring, T msg);
+    template <typename T> bool try_push(RingBuffer<T>& ring, T& msg, size_t bytes);
+    template <typename T> bool evict_oldest(RingBuffer<T>& ring);
+    bool evict_any();
+    template <typename T> bool sample_admit(const RingBuffer<T>& ring, size_t bytes) const;
+    template <typename T, typename Sink> void drain(RingBuffer<T>& ring, bool settle, Sink sink);
+    void enqueue_control(ControlSignal signal);
+    bool over_budget(size_t bytes) const;
+    bool shed_bulk(size_t bytes) const;
+    void wait_for_space(std::chrono::steady_clock::time_point deadline);
+    void wake();
+
+    // Producer staging (config_.staging_block_size() > 0)
+    template <typename T> bool stage(T& record, std::vector<T> StagedBlock::*lane);
+    StagingSlot* local_slot();
+    void drain_staging(bool detach);
+    void collect_staged();
 
     TellConfig config_;
     TcpTransport transport_;
     std::thread thread_;
 
-    // Channel
+    // Data channels: one lock-free ring per record type, so slots are sized
+    // to their type. Staged blocks get their own. Each ring holds
+    // queue_capacity messages; queued_bytes_ is the queue_max_bytes budget
+    // shared by all of them. mutex/cv only park the worker when idle.
+    RingBuffer<QueuedEvent> events_;
+    RingBuffer<QueuedLog> logs_;
+    RingBuffer<StagedBlock> blocks_;
+    std::atomic<size_t> queued_bytes_{0};
     std::mutex mutex_;
     std::condition_variable cv_;
-    std::queue<WorkerMessage> queue_;
-    static constexpr size_t MAX_QUEUE_SIZE = 10000;
+    std::atomic<bool> sleeping_{false};
+
+    // Producers parked by QueuePolicy::Block
+    std::mutex space_mutex_;
+    std::condition_variable space_cv_;
+    std::atomic<int> blocked_producers_{0};
+
+    // Out-of-band control channel (rare: flush/close only)
+    std::mutex control_mutex_;
+    std::vector<ControlSignal> control_;
+    std::atomic<bool> has_control_{false};
+
+    // High-severity log lane: bypasses the ring and is never shed, up to
+    // queue_capacity logs within the shared byte budget (rare by nature)
+    std::mutex priority_mutex_;
+    std::vector<QueuedLog> priority_;
+    std::atomic<bool> has_priority_{false};
+
+    // Per-thread staging slots, keyed in thread-local caches by id_
+    const uint64_t id_;
+    std::mutex staging_mutex_;
+    std::vector<std::shared_ptr<StagingSlot>> staging_slots_;
+    bool staging_closed_ = false;
 
     // Queues
     std::vector<QueuedEvent> event_queue_;
     std::vector<QueuedLog> log_queue_;
-
-    // Reusable encoding buffers
+    std::vector<QueuedLog> priority_queue_;
+    size_t event_bytes_ = 0;  // encoded size of event_queue_ (approx. upper bound)
+    size_t log_bytes_ = 0;    // encoded size of log_queue_
+
+    // Adaptive flush scheduling (config_.adaptive_linger())
+    std::optional<AdaptiveLinger> linger_;
+    size_t arrivals_ = 0;  // records added since the last linger update
+
+    // Reusable frame: encoded head plus segments referencing queued payloads,
+    // and the iovecs it is sent with
+    encoding::GatherFrame frame_;
+    std::vector<iovec> iov_;
+    // EventData/LogData staged for compression (config_.compression())
     std::vector<uint8_t> data_buf_;
-    std::vector<uint8_t> batch_buf_;
 
-    std::atomic<uint64_t> batch_counter_{1};
-    std::atomic<bool> running_{true};
+    std::atomic<uint64_t> batch_counter_;
+    const uint64_t batch_step_;
+    std::atomic<bool> running_{true};  // cleared under control_mutex_ on close
+    std::atomic<int> enqueuing_{0};    // producers between running_ check and push
+
+    // Tally for the next flush/close result (worker thread), plus drops
+    // counted on producer threads
+    FlushResult result_;
+    std::atomic<size_t> dropped_{0};
 
     // Managed retry threads (joined on shutdown instead of detached)
     std::mutex retry_mutex_;
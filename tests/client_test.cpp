@@ -5,15 +5,25 @@
 #include "tell/config.hpp"
 #include "tell/props.hpp"
 #include "tell/types.hpp"
+#include "decoding.hpp"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <chrono>
+#include <future>
+#include <map>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 namespace tell {
 namespace {
 
@@ -31,6 +41,98 @@ std::unique_ptr<Tell> make_test_client() {
     return Tell::create(std::move(config));
 }
 
+// Loopback server that keeps every frame it receives; the payloads are read
+// back through the decoder once the client has closed the connection(s).
+// frame_connections[i] is the accepted connection frames[i] arrived on and
+// frame_times[i] when its last byte was received.
+struct CaptureServer {
+    using clock = std::chrono::steady_clock;
+
+    std::string address;
+    std::vector<std::vector<uint8_t>> frames;
+    std::vector<size_t> frame_connections;
+    std::vector<clock::time_point> frame_times;
+    std::thread thread;
+    int listen_fd = -1;
+
+    explicit CaptureServer(size_t connections = 1) {
+        listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd, static_cast<int>(connections));
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        address = "127.0.0.1:" + std::to_string(ntohs(addr.sin_port));
+
+        thread = std::thread([this, connections] {
+            // Per connection: bytes, and (stream size, time) after each recv
+            std::vector<std::vector<uint8_t>> streams(connections);
+            std::vector<std::vector<std::pair<size_t, clock::time_point>>> received(connections);
+            std::vector<std::thread> readers;
+            for (size_t c = 0; c < connections; c++) {
+                int fd = ::accept(listen_fd, nullptr, nullptr);
+                if (fd < 0) break;
+                readers.emplace_back([fd, &stream = streams[c], &times = received[c]] {
+                    uint8_t chunk[64 * 1024];
+                    ssize_t n;
+                    while ((n = ::recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+                        stream.insert(stream.end(), chunk, chunk + n);
+                        times.emplace_back(stream.size(), clock::now());
+                    }
+                    ::close(fd);
+                });
+            }
+            for (auto& r : readers) r.join();
+            for (size_t c = 0; c < streams.size(); c++) {
+                const auto& stream = streams[c];
+                auto at = received[c].begin();
+                for (size_t pos = 0; pos + 4 <= stream.size();) {
+                    const uint8_t* prefix = stream.data() + pos;  // big-endian length
+                    size_t frame_len = (size_t(prefix[0]) << 24) | (size_t(prefix[1]) << 16) |
+                                       (size_t(prefix[2]) << 8) | prefix[3];
+                    if (pos + 4 + frame_len > stream.size()) break;
+                    frames.emplace_back(stream.begin() + static_cast<ptrdiff_t>(pos + 4),
+                                        stream.begin() + static_cast<ptrdiff_t>(pos + 4 + frame_len));
+                    frame_connections.push_back(c);
+                    pos += 4 + frame_len;
+                    while (at->first < pos) ++at;
+                    frame_times.push_back(at->second);
+                }
+            }
+        });
+    }
+
+    ~CaptureServer() {
+        if (thread.joinable()) thread.join();
+        ::close(listen_fd);
+    }
+
+    // Event and log payloads in arrival order, plus event names and log
+    // services when asked for; call after the client closed.
+    void payloads(std::vector<std::string>& events, std::vector<std::string>& logs,
+                  std::vector<std::string>* event_names = nullptr,
+                  std::vector<std::string>* services = nullptr) {
+        thread.join();
+        for (const auto& frame : frames) {
+            ASSERT_TRUE(decoding::Verifier(frame.data(), frame.size()).batch());
+            auto batch = decoding::BatchView::root(frame.data());
+            if (batch.schema_type() == SchemaType::Event) {
+                for (auto e : batch.event_data().events()) {
+                    events.emplace_back(e.payload().str());
+                    if (event_names) event_names->emplace_back(e.event_name());
+                }
+            } else {
+                for (auto l : batch.log_data().logs()) {
+                    logs.emplace_back(l.payload().str());
+                    if (services) services->emplace_back(l.service());
+                }
+            }
+        }
+    }
+};
+
 // ==================== Lifecycle ====================
 
 TEST(ClientTest, CreateAndClose) {
@@ -158,6 +260,109 @@ TEST(ClientTest, UnregisterAllThenTrack) {
     client->close();
 }
 
+static std::unique_ptr<Tell> make_capture_client(const CaptureServer& server) {
+    return Tell::create(TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint(server.address)
+        .batch_size(1000)
+        .flush_interval(std::chrono::milliseconds(60000))
+        .close_timeout(std::chrono::milliseconds(5000))
+        .build());
+}
+
+TEST(ClientTest, SuperPropsFollowRegisterAndUnregister) {
+    // Two clients on one thread: each must see its own super props
+    CaptureServer server, other_server;
+    auto client = make_capture_client(server);
+    auto other = make_capture_client(other_server);
+    other->register_props(Props().add("client", "other"));
+
+    client->track("u1", "A");
+    other->track("u1", "A");
+    client->register_props(Props().add("plan", "free").add("org", "Acme \"Inc\""));
+    client->track("u1", "B");
+    other->track("u1", "B");
+    client->register_props(Props().add("plan", "pro"));
+    client->group("u1", "g1");
+    client->unregister("org");
+    client->unregister("missing");
+    client->revenue("u1", 1.5, "USD", "o1");
+    client->unregister("plan");
+    client->track("u1", "C");
+    client->close();
+    other->close();
+
+    std::vector<std::string> events, logs, other_events;
+    server.payloads(events, logs);
+    other_server.payloads(other_events, logs);
+    ASSERT_EQ(events.size(), 5u);
+    EXPECT_EQ(events[0], R"({"user_id":"u1"})");
+    EXPECT_EQ(events[1], R"({"user_id":"u1","org":"Acme \"Inc\"","plan":"free"})");
+    EXPECT_EQ(events[2], R"({"group_id":"g1","user_id":"u1","org":"Acme \"Inc\"","plan":"pro"})");
+    EXPECT_EQ(events[3], R"({"user_id":"u1","amount":1.5,"currency":"USD","order_id":"o1","plan":"pro"})");
+    EXPECT_EQ(events[4], R"({"user_id":"u1"})");
+    ASSERT_EQ(other_events.size(), 2u);
+    EXPECT_EQ(other_events[0], R"({"user_id":"u1","client":"other"})");
+    EXPECT_EQ(other_events[1], R"({"user_id":"u1","client":"other"})");
+}
+
+TEST(ClientTest, NestedPropsAndSuperProps) {
+    CaptureServer server;
+    auto client = make_capture_client(server);
+    // Nested values survive the super props parser whole, commas and all
+    client->register_props(Props()
+        .begin_object("app").add("version", "2.0").add("build", 7).end_object()
+        .add("regions", {"eu", "us"})
+        .add("note", "a,b}"));
+    client->register_props(Props().begin_object("app").add("version", "2.1").end_object());
+
+    client->track("u1", "Checkout", Props()
+        .begin_array("items")
+            .begin_object().add("sku", "A1").add("qty", 2).end_object()
+        .end_array());
+    client->unregister("app");
+    client->track("u1", "Checkout");
+    client->close();
+
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0], R"({"user_id":"u1","app":{"version":"2.1"},"note":"a,b}","regions":["eu","us"],)"
+                         R"("items":[{"sku":"A1","qty":2}]})");
+    EXPECT_EQ(events[1], R"({"user_id":"u1","note":"a,b}","regions":["eu","us"]})");
+}
+
+TEST(ClientTest, SuperPropsSnapshotIsConsistentUnderConcurrentRegister) {
+    // a and b are always registered together, so every event must carry
+    // equal values: a snapshot is never seen half-updated.
+    CaptureServer server;
+    auto client = make_capture_client(server);
+    client->register_props(Props().add("a", 0).add("b", 0));
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 1; i <= 200; i++) client->register_props(Props().add("a", i).add("b", i));
+        done = true;
+    });
+    std::vector<std::thread> trackers;
+    for (int t = 0; t < 3; t++) {
+        trackers.emplace_back([&] {
+            for (int i = 0; i < 100 || !done; i++) client->track("u1", "E");
+        });
+    }
+    writer.join();
+    for (auto& t : trackers) t.join();
+    client->close();
+
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    ASSERT_GE(events.size(), 300u);
+    for (const auto& e : events) {
+        auto a = e.substr(e.find("\"a\":") + 4);
+        auto b = e.substr(e.find("\"b\":") + 4);
+        EXPECT_EQ(a.substr(0, a.find(',')), b.substr(0, b.find('}'))) << e;
+    }
+}
+
 // ==================== Session ====================
 
 TEST(ClientTest, ResetSession) {
@@ -189,6 +394,7 @@ TEST(ClientTest, ValidationErrors) {
     client->identify("");                    // empty user_id
     client->group("user", "");               // empty group_id
     client->revenue("user", -1, "USD", "o"); // negative amount
+    client->revenue("user", std::nan(""), "USD", "o"); // NaN amount
     client->revenue("user", 10, "", "o");    // empty currency
     client->revenue("user", 10, "USD", "");  // empty order_id
     client->alias("", "user");               // empty previous_id
@@ -196,7 +402,7 @@ TEST(ClientTest, ValidationErrors) {
 
     client->close();
 
-    EXPECT_EQ(error_count.load(), 9);
+    EXPECT_EQ(error_count.load(), 10);
 }
 
 // ==================== Concurrency ====================
@@ -281,6 +487,801 @@ TEST(ClientTest, ConcurrentFlush) {
     client->close();
 }
 
+// ==================== Producer Staging ====================
+
+std::unique_ptr<Tell> make_staging_client(size_t block_size,
+                                          const std::string& endpoint = "localhost:19999") {
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint(endpoint)
+        .batch_size(10)
+        .flush_interval(std::chrono::milliseconds(60000))
+        .close_timeout(std::chrono::milliseconds(2000))
+        .network_timeout(std::chrono::milliseconds(500))
+        .max_retries(0)
+        .staging_block_size(block_size)
+        .on_error([](const TellError&) {})
+        .build();
+    return Tell::create(std::move(config));
+}
+
+TEST(ClientTest, StagingFlushAndClose) {
+    CaptureServer server;
+    auto client = make_staging_client(16, server.address);
+    // 40 + 40 records: full blocks go out as they fill, flush() hands off the
+    // partial block, and close() the records staged after it.
+    for (int i = 0; i < 40; i++) {
+        client->track("user_1", "Event", Props().add("seq", i));
+        client->log_info("msg " + std::to_string(i));
+    }
+    auto flushed = client->flush_async().get();
+    EXPECT_EQ(flushed.events, 40u);
+    EXPECT_EQ(flushed.logs, 40u);
+    EXPECT_EQ(flushed.dropped, 0u);
+    client->track("user_1", "Event", Props().add("seq", 40));
+    auto closed = client->close_async().get();
+    EXPECT_EQ(closed.events, 1u);
+    EXPECT_EQ(closed.dropped, 0u);
+
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    ASSERT_EQ(events.size(), 41u);
+    ASSERT_EQ(logs.size(), 40u);
+    for (int i = 0; i <= 40; i++) {
+        EXPECT_EQ(events[i], R"({"user_id":"user_1","seq":)" + std::to_string(i) + "}");
+    }
+}
+
+TEST(ClientTest, StagingThreadExitPublishes) {
+    CaptureServer server;
+    auto client = make_staging_client(64, server.address);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        // Fewer records than a block: only thread exit hands them off.
+        threads.emplace_back([&client, t]() {
+            for (int i = 0; i < 5; i++) {
+                client->track("user_" + std::to_string(t), "Event", Props().add("seq", i));
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    auto closed = client->close_async().get();
+    EXPECT_EQ(closed.events, 20u);
+    EXPECT_EQ(closed.dropped, 0u);
+
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    ASSERT_EQ(events.size(), 20u);
+    for (int t = 0; t < 4; t++) {
+        std::string user = R"("user_id":"user_)" + std::to_string(t) + "\"";
+        int next = 0;
+        for (const auto& e : events) {
+            if (e.find(user) == std::string::npos) continue;
+            EXPECT_EQ(e, "{" + user + R"(,"seq":)" + std::to_string(next) + "}");
+            next++;
+        }
+        EXPECT_EQ(next, 5) << user;
+    }
+}
+
+TEST(ClientTest, StagingTrackAfterClose) {
+    CaptureServer server;
+    auto client = make_staging_client(8, server.address);
+    client->track("user_1", "Before Close");
+    EXPECT_EQ(client->close_async().get().events, 1u);
+
+    // This thread's cached slot is detached now: records must be counted as
+    // dropped instead of vanishing into it.
+    for (int i = 0; i < 3; i++) client->track("user_1", "After Close");
+    client->log_info("after close");
+    auto late = client->flush_async().get();
+    EXPECT_EQ(late.outcome, FlushOutcome::Dropped);
+    EXPECT_EQ(late.dropped, 4u);
+
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    EXPECT_EQ(events.size(), 1u);
+    EXPECT_TRUE(logs.empty());
+}
+
+TEST(ClientTest, StagingMultipleClientsSameThread) {
+    for (int round = 0; round < 3; round++) {
+        auto a = make_staging_client(8);
+        auto b = make_staging_client(8);
+        a->track("user_1", "A");
+        b->track("user_1", "B");
+        a->close();
+        b->close();
+    }
+}
+
+// ==================== Encode on Producer ====================
+
+// Runs the same concurrent workload with and without encode_on_producer and
+// returns every captured event as "name payload", sorted (threads interleave
+// differently from run to run).
+std::vector<std::string> encode_mode_events(bool on_producer) {
+    CaptureServer server;
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint(server.address)
+        .batch_size(10)
+        .close_timeout(std::chrono::milliseconds(5000))
+        .max_retries(0)
+        .encode_on_producer(on_producer)
+        .build();
+    auto client = Tell::create(std::move(config));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&client, t]() {
+            std::string big(70 * 1024, 'x'); // larger than one arena chunk
+            for (int i = 0; i < 100; i++) {
+                client->track("user_" + std::to_string(t), "Event", Props().add("seq", i));
+            }
+            client->track("user_" + std::to_string(t), "Big", Props().add("blob", big));
+            client->identify("user_" + std::to_string(t), Props().add("plan", "pro"));
+        });
+    }
+    for (auto& t : threads) t.join();
+    client->flush();
+    client->close();
+
+    std::vector<std::string> events, logs, names;
+    server.payloads(events, logs, &names);
+    for (size_t i = 0; i < events.size(); i++) events[i] = names[i] + " " + events[i];
+    std::sort(events.begin(), events.end());
+    return events;
+}
+
+TEST(ClientTest, EncodeOnProducerConcurrent) {
+    auto inline_events = encode_mode_events(false);
+    auto producer_events = encode_mode_events(true);
+    ASSERT_EQ(inline_events.size(), 4u * 102);
+    EXPECT_EQ(producer_events, inline_events);
+}
+
+// ==================== Backpressure ====================
+
+std::unique_ptr<Tell> make_policy_client(QueuePolicy policy, size_t capacity, size_t max_bytes = 0) {
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint("localhost:19999")
+        .batch_size(10)
+        .close_timeout(std::chrono::milliseconds(2000))
+        .network_timeout(std::chrono::milliseconds(200))
+        .max_retries(0)
+        .queue_policy(policy)
+        .queue_capacity(capacity)
+        .queue_max_bytes(max_bytes)
+        .queue_block_timeout(std::chrono::milliseconds(2))
+        .on_error([](const TellError&) {})
+        .build();
+    return Tell::create(std::move(config));
+}
+
+TEST(ClientTest, AllPoliciesSurviveOverload) {
+    for (auto policy : {QueuePolicy::DropOldest, QueuePolicy::DropNewest,
+                        QueuePolicy::Block, QueuePolicy::Sample}) {
+        auto client = make_policy_client(policy, 8, 4096);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&client]() {
+                for (int i = 0; i < 200; i++) {
+                    client->track("user_1", "Event", Props().add("seq", i));
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        // Unreachable endpoint: every record is accounted for as dropped,
+        // whether shed by the policy or by the failed send.
+        auto result = client->close_async().get();
+        EXPECT_EQ(result.dropped, 4u * 200) << static_cast<int>(policy);
+    }
+}
+
+// Holds the worker thread inside on_error, raised by one oversized record,
+// so the test can overfill the queue before anything is drained.
+struct WorkerGate {
+    std::promise<void> parked;
+    std::promise<void> released;
+    std::shared_future<void> release = released.get_future().share();
+    std::atomic<bool> used{false};
+
+    TellConfig::ErrorCallback on_error() {
+        return [this](const TellError&) {
+            if (used.exchange(true)) return;
+            parked.set_value();
+            release.wait();
+        };
+    }
+
+    // Park the worker: call before filling the queue. The gate record must
+    // be larger than max_frame_bytes.
+    void hold(Tell& client, size_t blob = 8192) {
+        client.track("gate", "Gate", Props().add("blob", std::string(blob, 'x')));
+        parked.get_future().wait();
+    }
+    void open() { released.set_value(); }
+};
+
+std::unique_ptr<Tell> make_gated_policy_client(QueuePolicy policy, size_t capacity,
+                                               const CaptureServer& server, WorkerGate& gate) {
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint(server.address)
+        .close_timeout(std::chrono::milliseconds(5000))
+        .max_retries(0)
+        .queue_policy(policy)
+        .queue_capacity(capacity)
+        .queue_block_timeout(std::chrono::milliseconds(50))
+        .max_batch_bytes(2048)
+        .max_frame_bytes(4096)
+        .on_error(gate.on_error())
+        .build();
+    return Tell::create(std::move(config));
+}
+
+// Sequence numbers of the captured events, in arrival order.
+std::vector<int> captured_seqs(CaptureServer& server) {
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    std::vector<int> seqs;
+    for (const auto& e : events) {
+        auto at = e.find("\"seq\":");
+        if (at != std::string::npos) seqs.push_back(std::stoi(e.substr(at + 6)));
+    }
+    return seqs;
+}
+
+std::vector<int> seq_range(int first, int last) {
+    std::vector<int> seqs;
+    for (int i = first; i <= last; i++) seqs.push_back(i);
+    return seqs;
+}
+
+TEST(ClientTest, DropNewestKeepsOldestRecords) {
+    CaptureServer server;
+    WorkerGate gate;
+    auto client = make_gated_policy_client(QueuePolicy::DropNewest, 8, server, gate);
+    gate.hold(*client);
+    for (int i = 0; i < 20; i++) client->track("user_1", "Event", Props().add("seq", i));
+    gate.open();
+
+    auto result = client->close_async().get();
+    EXPECT_EQ(result.outcome, FlushOutcome::Dropped);
+    EXPECT_EQ(result.events, 8u);
+    EXPECT_EQ(result.dropped, 12u + 1);  // plus the oversized gate record
+    EXPECT_EQ(captured_seqs(server), seq_range(0, 7));
+}
+
+TEST(ClientTest, DropOldestKeepsNewestRecords) {
+    CaptureServer server;
+    WorkerGate gate;
+    auto client = make_gated_policy_client(QueuePolicy::DropOldest, 8, server, gate);
+    gate.hold(*client);
+    for (int i = 0; i < 20; i++) client->track("user_1", "Event", Props().add("seq", i));
+    gate.open();
+
+    auto result = client->close_async().get();
+    EXPECT_EQ(result.events, 8u);
+    EXPECT_EQ(result.dropped, 12u + 1);
+    EXPECT_EQ(captured_seqs(server), seq_range(12, 19));
+}
+
+TEST(ClientTest, BlockWaitsForTimeoutThenDrops) {
+    CaptureServer server;
+    WorkerGate gate;
+    auto client = make_gated_policy_client(QueuePolicy::Block, 8, server, gate);
+    gate.hold(*client);
+    for (int i = 0; i < 8; i++) client->track("user_1", "Event", Props().add("seq", i));
+
+    // Queue full: each further record waits out queue_block_timeout (50ms)
+    auto start = std::chrono::steady_clock::now();
+    client->track("user_1", "Event", Props().add("seq", 8));
+    client->track("user_1", "Event", Props().add("seq", 9));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    gate.open();
+
+    EXPECT_GE(elapsed, std::chrono::milliseconds(2 * 50));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(2 * 50 + 500));
+    auto result = client->close_async().get();
+    EXPECT_EQ(result.events, 8u);
+    EXPECT_EQ(result.dropped, 2u + 1);
+    EXPECT_EQ(captured_seqs(server), seq_range(0, 7));
+}
+
+TEST(ClientTest, BlockedProducersReleasedOnClose) {
+    // Producers keep a one-slot queue full, so some are parked in Block at
+    // close. Nothing drains after close: they must drop right away instead of
+    // waiting out the 5s block timeout.
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint("localhost:19999")
+        .close_timeout(std::chrono::milliseconds(2000))
+        .network_timeout(std::chrono::milliseconds(200))
+        .max_retries(0)
+        .queue_policy(QueuePolicy::Block)
+        .queue_capacity(1)
+        .queue_block_timeout(std::chrono::seconds(5))
+        .on_error([](const TellError&) {})
+        .build();
+    auto client = Tell::create(std::move(config));
+    std::atomic<bool> closed{false};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; t++) {
+        producers.emplace_back([&]() {
+            while (!closed.load()) client->track("user_1", "Event");
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    client->close_async().get();
+    closed.store(true);
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto& t : producers) t.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST(ClientTest, SampleThinsAboveHalfCapacity) {
+    CaptureServer server;
+    WorkerGate gate;
+    auto client = make_gated_policy_client(QueuePolicy::Sample, 64, server, gate);
+    gate.hold(*client);
+    // As many records as the queue holds: below half everything is admitted,
+    // above it admission falls off, so the queue never fills.
+    for (int i = 0; i < 64; i++) client->track("user_1", "Event", Props().add("seq", i));
+    gate.open();
+
+    auto result = client->close_async().get();
+    auto seqs = captured_seqs(server);
+    ASSERT_GE(seqs.size(), 32u);
+    EXPECT_LT(seqs.size(), 64u);
+    EXPECT_EQ(std::vector<int>(seqs.begin(), seqs.begin() + 32), seq_range(0, 31));
+    EXPECT_EQ(result.events, seqs.size());
+    EXPECT_EQ(result.dropped, 64 - seqs.size() + 1);
+}
+
+// Logs fill a shared 40 KB byte budget, then optionally one event takes up
+// most of it. Returns the captured logs and events.
+std::pair<std::vector<std::string>, std::vector<std::string>> fill_budget_with_logs(bool big_event) {
+    CaptureServer server;
+    WorkerGate gate;
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint(server.address)
+        .close_timeout(std::chrono::milliseconds(5000))
+        .max_retries(0)
+        .queue_policy(QueuePolicy::DropOldest)
+        .queue_max_bytes(40 * 1024)
+        .max_batch_bytes(16 * 1024)
+        .max_frame_bytes(32 * 1024)
+        .on_error(gate.on_error())
+        .build();
+    auto client = Tell::create(std::move(config));
+    gate.hold(*client, 36 * 1024);
+    for (int i = 0; i < 600; i++) client->log_info("log " + std::to_string(i));
+    if (big_event) client->track("user_1", "Big", Props().add("pad", std::string(30 * 1024, 'p')));
+    gate.open();
+    client->close();
+
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    return {logs, events};
+}
+
+TEST(ClientTest, DropOldestEvictsAcrossRingsForByteBudget) {
+    // The event ring is empty, so the event can only fit the shared byte
+    // budget by evicting logs; it must not push past the budget instead.
+    auto [logs_only, no_events] = fill_budget_with_logs(false);
+    auto [logs, events] = fill_budget_with_logs(true);
+    ASSERT_EQ(events.size(), 1u);
+    ASSERT_GT(logs_only.size(), 100u);
+    // 30 KB of 40 KB went to the event: most of the logs had to go
+    EXPECT_LT(logs.size(), logs_only.size() / 2);
+    EXPECT_EQ(logs.back(), R"({"message":"log 599"})");
+    EXPECT_EQ(logs_only.back(), logs.back());
+}
+
+TEST(ClientTest, ControlSignalsNeverDropped) {
+    // Capacity 1 with drop-oldest: a flush riding the data queue would be
+    // evicted and flush() would wait out the full close_timeout.
+    auto client = make_policy_client(QueuePolicy::DropOldest, 1);
+    std::atomic<bool> stop{false};
+    std::thread producer([&]() {
+        while (!stop.load()) client->track("user_1", "Event");
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 5; i++) client->flush();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    stop.store(true);
+    producer.join();
+    client->close();
+    EXPECT_LT(elapsed, std::chrono::milliseconds(2000));
+}
+
+TEST(ClientTest, PriorityLogsUnderOverload) {
+    // Bulk debug spam saturates a tiny queue; critical logs take the high
+    // lane and a flush still completes promptly.
+    auto client = make_policy_client(QueuePolicy::Block, 4);
+    std::atomic<bool> stop{false};
+    std::thread spammer([&]() {
+        while (!stop.load()) client->log_debug("noise");
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 50; i++) {
+        client->log_critical("disk full", "storage");
+        client->log_emergency("down");
+    }
+    client->flush();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    stop.store(true);
+    spammer.join();
+    client->close();
+    EXPECT_LT(elapsed, std::chrono::milliseconds(2000));
+}
+
+TEST(ClientTest, StagedBulkLogsShedBeforeInfo) {
+    // One record per staged block, so every log takes the staged-block ring:
+    // past half of it, debug logs are shed and info logs still get in.
+    CaptureServer server;
+    WorkerGate gate;
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint(server.address)
+        .close_timeout(std::chrono::milliseconds(5000))
+        .max_retries(0)
+        .staging_block_size(1)
+        .queue_policy(QueuePolicy::DropNewest)
+        .queue_capacity(8)
+        .max_batch_bytes(2048)
+        .max_frame_bytes(4096)
+        .on_error(gate.on_error())
+        .build();
+    auto client = Tell::create(std::move(config));
+    gate.hold(*client);
+    for (int i = 0; i < 4; i++) client->log_info("info " + std::to_string(i));
+    for (int i = 0; i < 10; i++) client->log_debug("debug " + std::to_string(i));
+    for (int i = 4; i < 8; i++) client->log_info("info " + std::to_string(i));
+    gate.open();
+
+    auto result = client->close_async().get();
+    EXPECT_EQ(result.logs, 8u);
+    EXPECT_EQ(result.dropped, 10u + 1);  // plus the oversized gate record
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    ASSERT_EQ(logs.size(), 8u);
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(logs[i], R"({"message":"info )" + std::to_string(i) + "\"}");
+    }
+}
+
+TEST(ClientTest, PriorityLaneIsBounded) {
+    // The high lane is never shed for other records, but it holds at most
+    // queue_capacity logs: a burst past that is dropped, not buffered.
+    CaptureServer server;
+    WorkerGate gate;
+    auto client = make_gated_policy_client(QueuePolicy::DropOldest, 8, server, gate);
+    gate.hold(*client);
+    for (int i = 0; i < 20; i++) client->log_critical("critical " + std::to_string(i));
+    gate.open();
+
+    auto result = client->close_async().get();
+    EXPECT_EQ(result.logs, 8u);
+    EXPECT_EQ(result.dropped, 12u + 1);  // plus the oversized gate record
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    ASSERT_EQ(logs.size(), 8u);
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(logs[i], R"({"message":"critical )" + std::to_string(i) + "\"}");
+    }
+}
+
+TEST(ClientTest, PriorityLogsAfterCloseAreDropped) {
+    auto client = make_policy_client(QueuePolicy::DropOldest, 100);
+    client->close();
+
+    for (int i = 0; i < 3; i++) client->log_critical("late");
+    client->log_debug("late");
+    client->track("user_1", "Late");
+    auto result = client->flush_async().get();
+    EXPECT_EQ(result.outcome, FlushOutcome::Dropped);
+    EXPECT_EQ(result.dropped, 5u);
+}
+
+// ==================== Batch Byte Limits ====================
+
+TEST(ClientTest, OversizedRecordReportsSerializationError) {
+    std::atomic<int> serialization_errors{0};
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint("localhost:19999")
+        .close_timeout(std::chrono::milliseconds(2000))
+        .network_timeout(std::chrono::milliseconds(200))
+        .max_retries(0)
+        .max_batch_bytes(2048)
+        .max_frame_bytes(4096)
+        .on_error([&](const TellError& e) {
+            if (e.kind() == ErrorKind::Serialization) serialization_errors++;
+        })
+        .build();
+    auto client = Tell::create(std::move(config));
+
+    for (int i = 0; i < 50; i++) {
+        client->track("user_1", "Event", Props().add("pad", std::string(300, 'x')));
+    }
+    client->track("user_1", "Huge", Props().add("blob", std::string(8192, 'x')));
+    client->log_info(std::string(8192, 'x'));
+    client->close();
+
+    EXPECT_EQ(serialization_errors.load(), 2);
+}
+
+// ==================== Adaptive Linger ====================
+
+struct LingerRun {
+    size_t events = 0;
+    size_t frames = 0;
+    std::chrono::nanoseconds max_latency{0};  // of records not flushed by close()
+};
+
+// 4 producers offer `per_ms` events per millisecond in total for 100ms. Each
+// event carries its enqueue time; latency is measured to frame arrival.
+LingerRun run_linger_load(bool adaptive, size_t batch_size, int per_ms, std::chrono::milliseconds bound) {
+    CaptureServer server;
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint(server.address)
+        .batch_size(batch_size)
+        .flush_interval(bound)
+        .close_timeout(std::chrono::milliseconds(5000))
+        .max_retries(0)
+        .adaptive_linger(adaptive)
+        .max_latency(bound)
+        .build();
+    auto client = Tell::create(std::move(config));
+
+    using clock = CaptureServer::clock;
+    auto start = clock::now() + std::chrono::milliseconds(5);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&client, start, per_ms]() {
+            for (int ms = 0; ms < 100; ms++) {
+                std::this_thread::sleep_until(start + std::chrono::milliseconds(ms));
+                for (int i = 0; i < per_ms / 4; i++) {
+                    auto now = clock::now().time_since_epoch().count();
+                    client->track("user_1", "Event", Props().add("t", static_cast<int64_t>(now)));
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    auto closing = clock::now();
+    client->close();
+
+    LingerRun run;
+    server.thread.join();
+    run.frames = server.frames.size();
+    for (size_t f = 0; f < server.frames.size(); f++) {
+        auto batch = decoding::BatchView::root(server.frames[f].data());
+        for (auto e : batch.event_data().events()) {
+            run.events++;
+            if (server.frame_times[f] >= closing) continue;
+            std::string payload(e.payload().str());
+            clock::time_point enqueued(clock::duration(std::stoll(payload.substr(payload.find("\"t\":") + 4))));
+            run.max_latency = std::max<std::chrono::nanoseconds>(run.max_latency, server.frame_times[f] - enqueued);
+        }
+    }
+    return run;
+}
+
+TEST(ClientTest, AdaptiveLingerConcurrent) {
+    // Fixed mode only matches adaptive's low-traffic latency by sending
+    // every record on its own; adaptive batches once the rate picks up.
+    auto bound = std::chrono::milliseconds(50);
+    auto fixed = run_linger_load(false, 1, 40, bound);
+    auto adaptive = run_linger_load(true, 1000, 40, bound);
+    EXPECT_EQ(fixed.events, 4000u);
+    EXPECT_EQ(adaptive.events, 4000u);
+    EXPECT_LT(adaptive.max_latency, bound);
+    EXPECT_LT(adaptive.frames, fixed.frames / 2);
+}
+
+TEST(ClientTest, AdaptiveLingerHoldsTailAfterBatchFlush) {
+    // 25 records drained in one wakeup with batch_size 10: two full batches
+    // go out while draining. The 5 left are under min_batch_size and must
+    // wait for max_latency instead of going out in a small extra frame.
+    CaptureServer server;
+    WorkerGate gate;
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint(server.address)
+        .batch_size(10)
+        .close_timeout(std::chrono::milliseconds(5000))
+        .max_retries(0)
+        .adaptive_linger(true)
+        .min_batch_size(8)
+        .max_latency(std::chrono::milliseconds(10000))
+        .max_batch_bytes(2048)
+        .max_frame_bytes(4096)
+        .on_error(gate.on_error())
+        .build();
+    auto client = Tell::create(std::move(config));
+    gate.hold(*client);
+    for (int i = 0; i < 25; i++) client->track("user_1", "Event", Props().add("seq", i));
+    gate.open();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto closing = CaptureServer::clock::now();
+    client->close();
+
+    server.thread.join();
+    ASSERT_EQ(server.frames.size(), 3u);
+    EXPECT_LT(server.frame_times[1], closing);
+    EXPECT_GE(server.frame_times[2], closing);  // the tail went out with close()
+    EXPECT_EQ(decoding::BatchView::root(server.frames[2].data()).event_data().events().size(), 5u);
+}
+
+// ==================== Sharded Workers ====================
+
+TEST(ClientTest, ShardedWorkersConcurrent) {
+    CaptureServer server(4);
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint(server.address)
+        .batch_size(10)
+        .close_timeout(std::chrono::milliseconds(2000))
+        .max_retries(0)
+        .workers(4)
+        .build();
+    auto client = Tell::create(std::move(config));
+
+    // Each thread owns 10 users, so each user's events have one producer
+    // and a defined order.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&client, t]() {
+            for (int i = 0; i < 100; i++) {
+                client->track("user_" + std::to_string(t * 10 + i % 10), "Event", Props().add("seq", i));
+                client->log_info("message " + std::to_string(t));
+            }
+            client->flush();
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    auto start = std::chrono::steady_clock::now();
+    client->close();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    // Shards close in parallel against one shared deadline
+    EXPECT_LT(elapsed, std::chrono::milliseconds(3000));
+
+    // Every user's events arrive on a single connection (shard), in order
+    server.thread.join();
+    std::map<std::string, std::vector<int>> seqs;
+    std::map<std::string, std::set<size_t>> shards;
+    std::set<size_t> used;
+    size_t logs = 0;
+    for (size_t f = 0; f < server.frames.size(); f++) {
+        const auto& frame = server.frames[f];
+        ASSERT_TRUE(decoding::Verifier(frame.data(), frame.size()).batch());
+        auto batch = decoding::BatchView::root(frame.data());
+        if (batch.schema_type() == SchemaType::Log) {
+            logs += batch.log_data().logs().size();
+            continue;
+        }
+        for (auto e : batch.event_data().events()) {
+            std::string payload(e.payload().str());
+            auto user_end = payload.find('"', 12);
+            std::string user = payload.substr(12, user_end - 12);  // after {"user_id":"
+            seqs[user].push_back(std::stoi(payload.substr(payload.find("\"seq\":") + 6)));
+            shards[user].insert(server.frame_connections[f]);
+            used.insert(server.frame_connections[f]);
+        }
+    }
+    EXPECT_EQ(logs, 4u * 100);
+    ASSERT_EQ(seqs.size(), 40u);
+    for (const auto& [user, list] : seqs) {
+        EXPECT_EQ(shards[user].size(), 1u) << user;
+        int u = std::stoi(user.substr(5)) % 10;
+        std::vector<int> expected;
+        for (int i = u; i < 100; i += 10) expected.push_back(i);
+        EXPECT_EQ(list, expected) << user;
+    }
+    EXPECT_GT(used.size(), 1u);  // users are spread over shards
+}
+
+// ==================== Async Flush ====================
+
+TEST(ClientTest, FlushAsyncReportsDroppedWhenUnreachable) {
+    auto client = make_policy_client(QueuePolicy::DropOldest, 100);
+    for (int i = 0; i < 5; i++) client->track("user_1", "Event");
+    for (int i = 0; i < 3; i++) client->log_info("message");
+
+    auto f = client->flush_async();
+    ASSERT_EQ(f.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    auto result = f.get();
+    EXPECT_EQ(result.outcome, FlushOutcome::Dropped);
+    EXPECT_EQ(result.events, 0u);
+    EXPECT_EQ(result.logs, 0u);
+    EXPECT_EQ(result.dropped, 8u);
+
+    // Next flush only covers what happened since
+    auto empty = client->flush_async().get();
+    EXPECT_EQ(empty.outcome, FlushOutcome::Sent);
+    EXPECT_EQ(empty.dropped, 0u);
+    client->close();
+}
+
+TEST(ClientTest, FlushAsyncReportsQueuedForRetry) {
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .endpoint("localhost:19999")
+        .network_timeout(std::chrono::milliseconds(200))
+        .max_retries(1)
+        .workers(2)
+        .on_error([](const TellError&) {})
+        .build();
+    auto client = Tell::create(std::move(config));
+    for (int i = 0; i < 10; i++) client->track("user_" + std::to_string(i), "Event");
+
+    auto result = client->flush_async().get();
+    EXPECT_EQ(result.outcome, FlushOutcome::QueuedForRetry);
+    EXPECT_EQ(result.events, 10u);
+}
+
+TEST(ClientTest, TrackRacingCloseIsAccounted) {
+    // Records that race with close are sent or counted as dropped, never
+    // left behind in the queue.
+    for (int round = 0; round < 10; round++) {
+        CaptureServer server;
+        auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+            .endpoint(server.address)
+            .batch_size(16)
+            .close_timeout(std::chrono::milliseconds(5000))
+            .max_retries(0)
+            .queue_capacity(64)
+            .on_error([](const TellError&) {})
+            .build();
+        auto client = Tell::create(std::move(config));
+        // Connect first, in case the race sheds every record
+        client->track("user_1", "First");
+        ASSERT_EQ(client->flush_async().get().events, 1u);
+        std::atomic<bool> closed{false};
+        std::atomic<size_t> attempted{0};
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; t++) {
+            producers.emplace_back([&]() {
+                while (!closed.load()) {
+                    client->track("user_1", "Event");
+                    attempted.fetch_add(1);
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        auto result = client->close_async().get();
+        closed.store(true);
+        for (auto& t : producers) t.join();
+        auto late = client->flush_async().get();
+
+        std::vector<std::string> events, logs;
+        server.payloads(events, logs);
+        EXPECT_EQ(events.size(), 1 + result.events) << round;
+        EXPECT_EQ(result.events + result.dropped + late.dropped, attempted.load()) << round;
+    }
+}
+
+TEST(ClientTest, CloseAsyncCallbackAndLateFlush) {
+    auto client = make_policy_client(QueuePolicy::DropOldest, 100);
+    client->track("user_1", "Event");
+
+    std::promise<FlushResult> closed;
+    client->close_async([&closed](const FlushResult& r) { closed.set_value(r); });
+    auto f = closed.get_future();
+    ASSERT_EQ(f.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(f.get().dropped, 1u);
+
+    // After close, records are dropped and signals answer immediately
+    client->track("user_1", "Late");
+    auto late = client->flush_async();
+    ASSERT_EQ(late.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    auto result = late.get();
+    EXPECT_EQ(result.outcome, FlushOutcome::Dropped);
+    EXPECT_EQ(result.dropped, 1u);
+}
+
 // ==================== Timeout ====================
 
 TEST(ClientTest, FlushReturnsWithinTimeout) {
@@ -322,5 +1323,106 @@ TEST(ClientTest, CloseReturnsWithinTimeout) {
     EXPECT_LT(elapsed, std::chrono::seconds(3));
 }
 
+// ==================== Owned Props ====================
+
+TEST(ClientTest, OwnedPropsPayloadsMatchBorrowed) {
+    CaptureServer server;
+    auto client = make_capture_client(server);
+    client->register_props(Props().add("region", "eu"));
+
+    // Empty, inline and spilled property sets
+    auto make = [](int n) {
+        Props p;
+        for (int i = 0; i < n; i++) p.add("key_" + std::to_string(i), "v\"" + std::to_string(i));
+        return p;
+    };
+    const int sizes[] = {0, 2, 40};
+    for (int n : sizes) {
+        const Props borrowed = make(n);
+        client->track("u1", "Page Viewed", borrowed);
+        client->track("u1", "Page Viewed", make(n));
+        client->identify("u1", borrowed);
+        client->identify("u1", make(n));
+        client->group("u1", "g1", borrowed);
+        client->group("u1", "g1", make(n));
+        client->revenue("u1", 9.99, "USD", "o1", borrowed);
+        client->revenue("u1", 9.99, "USD", "o1", make(n));
+        client->log_info("started", "api", borrowed);
+        client->log_info("started", "api", make(n));
+    }
+    client->close();
+
+    std::vector<std::string> events, logs;
+    server.payloads(events, logs);
+    ASSERT_EQ(events.size(), 3u * 4 * 2);
+    ASSERT_EQ(logs.size(), 3u * 2);
+    for (size_t i = 0; i < events.size(); i += 2) EXPECT_EQ(events[i + 1], events[i]) << i;
+    for (size_t i = 0; i < logs.size(); i += 2) EXPECT_EQ(logs[i + 1], logs[i]) << i;
+
+    // n = 0, then n = 2
+    EXPECT_EQ(events[0], R"({"user_id":"u1","region":"eu"})");
+    EXPECT_EQ(events[2], R"({"user_id":"u1"})");
+    EXPECT_EQ(events[8], R"({"user_id":"u1","region":"eu","key_0":"v\"0","key_1":"v\"1"})");
+    EXPECT_EQ(events[10], R"({"user_id":"u1","traits":{"key_0":"v\"0","key_1":"v\"1"}})");
+    EXPECT_EQ(events[12], R"({"group_id":"g1","user_id":"u1","region":"eu","key_0":"v\"0","key_1":"v\"1"})");
+    EXPECT_EQ(events[14], R"({"user_id":"u1","amount":9.99,"currency":"USD","order_id":"o1","region":"eu",)"
+                          R"("key_0":"v\"0","key_1":"v\"1"})");
+    EXPECT_EQ(logs[0], R"({"message":"started"})");
+    EXPECT_EQ(logs[2], R"({"message":"started","key_0":"v\"0","key_1":"v\"1"})");
+}
+
+// ==================== String Views ====================
+
+// Arguments are encoded from the view alone: views cut out of a larger
+// buffer (no terminating NUL) must not pick up the bytes after them.
+TEST(ClientTest, StringViewArgumentsEncodeFromView) {
+    CaptureServer server;
+    auto client = make_capture_client(server);
+
+    const std::string text = "u1|Subscription Canceled|g1|USD|o1|anon|disk full|api|plan";
+    std::string_view all = text;
+    std::vector<std::string_view> parts;
+    for (size_t start = 0; start <= text.size();) {
+        size_t end = text.find('|', start);
+        if (end == std::string::npos) end = text.size();
+        parts.push_back(all.substr(start, end - start));
+        start = end + 1;
+    }
+    ASSERT_EQ(parts.size(), 9u);
+
+    client->track(parts[0], parts[1], Props().add(parts[8], parts[1]));
+    client->track("u1", Events::SUBSCRIPTION_CANCELED);
+    client->track(std::string("u1"), std::string("Page Viewed"));
+    client->group(parts[0], parts[2]);
+    client->revenue(parts[0], 5.0, parts[3], parts[4]);
+    client->alias(parts[5], parts[0]);
+    client->log_error(parts[6], parts[7]);
+    client->close();
+
+    std::vector<std::string> events, logs, names, services;
+    server.payloads(events, logs, &names, &services);
+    ASSERT_EQ(events.size(), 6u);
+    EXPECT_EQ(names[0], "Subscription Canceled");
+    EXPECT_EQ(events[0], R"({"user_id":"u1","plan":"Subscription Canceled"})");
+    EXPECT_EQ(names[1], Events::SUBSCRIPTION_CANCELED);
+    EXPECT_EQ(names[2], "Page Viewed");
+    EXPECT_EQ(events[3], R"({"group_id":"g1","user_id":"u1"})");
+    EXPECT_EQ(events[4], R"({"user_id":"u1","amount":5,"currency":"USD","order_id":"o1"})");
+    EXPECT_EQ(events[5], R"({"previous_id":"anon","user_id":"u1"})");
+    ASSERT_EQ(logs.size(), 1u);
+    EXPECT_EQ(logs[0], R"({"message":"disk full"})");
+    EXPECT_EQ(services[0], "api");
+}
+
+TEST(ClientTest, OwnedPropsAreLeftEmpty) {
+    auto client = make_test_client();
+    Props props;
+    props.add("url", "/home");
+    client->track("u1", "Page Viewed", std::move(props));
+    EXPECT_TRUE(props.empty());
+    EXPECT_EQ(props.json(), "{}");
+    client->close();
+}
+
 } // namespace
 } // namespace tell
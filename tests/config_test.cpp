@@ -59,6 +59,138 @@ TEST(ConfigTest, BuilderCustomValues) {
     EXPECT_EQ(config.network_timeout(), std::chrono::milliseconds(60000));
 }
 
+TEST(ConfigTest, StagingDisabledByDefault) {
+    auto config = TellConfig::production("feed1e11feed1e11feed1e11feed1e11");
+    EXPECT_EQ(config.staging_block_size(), 0u);
+
+    auto staged = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .staging_block_size(64)
+        .build();
+    EXPECT_EQ(staged.staging_block_size(), 64u);
+}
+
+TEST(ConfigTest, QueueDefaults) {
+    auto config = TellConfig::production("feed1e11feed1e11feed1e11feed1e11");
+    EXPECT_EQ(config.queue_policy(), QueuePolicy::DropOldest);
+    EXPECT_EQ(config.queue_capacity(), 10000u);
+    EXPECT_EQ(config.queue_max_bytes(), 0u);
+}
+
+TEST(ConfigTest, QueueCustomValues) {
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .queue_policy(QueuePolicy::Block)
+        .queue_capacity(512)
+        .queue_max_bytes(1 << 20)
+        .queue_block_timeout(std::chrono::milliseconds(5))
+        .build();
+    EXPECT_EQ(config.queue_policy(), QueuePolicy::Block);
+    EXPECT_EQ(config.queue_capacity(), 512u);
+    EXPECT_EQ(config.queue_max_bytes(), size_t(1) << 20);
+    EXPECT_EQ(config.queue_block_timeout(), std::chrono::milliseconds(5));
+}
+
+TEST(ConfigTest, EncodeOnProducer) {
+    EXPECT_FALSE(TellConfig::production("feed1e11feed1e11feed1e11feed1e11").encode_on_producer());
+    auto config = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .encode_on_producer(true)
+        .build();
+    EXPECT_TRUE(config.encode_on_producer());
+}
+
+TEST(ConfigTest, ZeroQueueCapacityRejected) {
+    EXPECT_THROW(TellConfig::builder("feed1e11feed1e11feed1e11feed1e11").queue_capacity(0).build(), TellError);
+}
+
+TEST(ConfigTest, Workers) {
+    auto config = TellConfig::production("feed1e11feed1e11feed1e11feed1e11");
+    EXPECT_EQ(config.workers(), 1u);
+
+    auto sharded = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .workers(4)
+        .build();
+    EXPECT_EQ(sharded.workers(), 4u);
+
+    EXPECT_THROW(TellConfig::builder("feed1e11feed1e11feed1e11feed1e11").workers(0).build(), TellError);
+}
+
+TEST(ConfigTest, LogLanes) {
+    auto config = TellConfig::production("feed1e11feed1e11feed1e11feed1e11");
+    EXPECT_EQ(config.priority_log_level(), LogLevel::Critical);
+    EXPECT_EQ(config.bulk_log_level(), LogLevel::Debug);
+
+    auto custom = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .priority_log_level(LogLevel::Error)
+        .bulk_log_level(LogLevel::Info)
+        .build();
+    EXPECT_EQ(custom.priority_log_level(), LogLevel::Error);
+    EXPECT_EQ(custom.bulk_log_level(), LogLevel::Info);
+
+    EXPECT_THROW(TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .priority_log_level(LogLevel::Debug)
+        .bulk_log_level(LogLevel::Debug)
+        .build(), TellError);
+}
+
+TEST(ConfigTest, BatchByteLimits) {
+    auto config = TellConfig::production("feed1e11feed1e11feed1e11feed1e11");
+    EXPECT_EQ(config.max_batch_bytes(), 0u);
+    EXPECT_EQ(config.max_frame_bytes(), 0u);
+
+    auto custom = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .max_batch_bytes(16 * 1024)
+        .max_frame_bytes(64 * 1024)
+        .build();
+    EXPECT_EQ(custom.max_batch_bytes(), 16u * 1024);
+    EXPECT_EQ(custom.max_frame_bytes(), 64u * 1024);
+
+    // Either limit can be set on its own
+    auto frame_only = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .max_frame_bytes(16 * 1024)
+        .build();
+    EXPECT_EQ(frame_only.max_batch_bytes(), 0u);
+    EXPECT_EQ(frame_only.max_frame_bytes(), 16u * 1024);
+
+    EXPECT_THROW(TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .max_batch_bytes(64 * 1024)
+        .max_frame_bytes(16 * 1024)
+        .build(), TellError);
+}
+
+TEST(ConfigTest, AdaptiveLinger) {
+    auto config = TellConfig::production("feed1e11feed1e11feed1e11feed1e11");
+    EXPECT_FALSE(config.adaptive_linger());
+    EXPECT_EQ(config.max_latency(), std::chrono::milliseconds(200));
+    EXPECT_EQ(config.min_batch_size(), 1u);
+
+    auto custom = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .adaptive_linger(true)
+        .max_latency(std::chrono::milliseconds(20))
+        .min_batch_size(5)
+        .build();
+    EXPECT_TRUE(custom.adaptive_linger());
+    EXPECT_EQ(custom.max_latency(), std::chrono::milliseconds(20));
+    EXPECT_EQ(custom.min_batch_size(), 5u);
+
+    EXPECT_THROW(TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .adaptive_linger(true)
+        .batch_size(10)
+        .min_batch_size(20)
+        .build(), TellError);
+}
+
+TEST(ConfigTest, Compression) {
+    auto config = TellConfig::production("feed1e11feed1e11feed1e11feed1e11");
+    EXPECT_EQ(config.compression(), Compression::None);
+    EXPECT_EQ(config.compression_min_bytes(), 1024u);
+
+    auto custom = TellConfig::builder("feed1e11feed1e11feed1e11feed1e11")
+        .compression(Compression::Lz4)
+        .compression_min_bytes(0)
+        .build();
+    EXPECT_EQ(custom.compression(), Compression::Lz4);
+    EXPECT_EQ(custom.compression_min_bytes(), 0u);
+}
+
 TEST(ConfigTest, ApiKeyDecodedCorrectly) {
     auto config = TellConfig::production("feed1e11feed1e11feed1e11feed1e11");
     auto bytes = config.api_key_bytes();
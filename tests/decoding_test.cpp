@@ -0,0 +1,252 @@
+// tests/decoding_test.cpp
+// Unit tests for the zero-copy frame views and verifier.
+
+#include <gtest/gtest.h>
+#include "decoding.hpp"
+#include "encoding.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace tell;
+using namespace tell::encoding;
+using namespace tell::decoding;
+
+namespace {
+
+const uint8_t API_KEY[16] = {0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8,
+                             0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF, 0xB0};
+const uint8_t DEVICE[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+const uint8_t SESSION[16] = {16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1};
+
+BatchParams header(SchemaType schema) {
+    BatchParams bp;
+    bp.api_key = API_KEY;
+    bp.schema_type = schema;
+    bp.batch_id = 42;
+    return bp;
+}
+
+std::string str(Bytes b) { return std::string(b.str()); }
+
+// Mixed presence: every other event has no session, the third no payload,
+// and two names alternate (shared vtables and pooled strings).
+struct SampleEvents {
+    std::vector<std::string> payloads;
+    std::vector<EventParams> params;
+
+    explicit SampleEvents(size_t n) {
+        for (size_t i = 0; i < n; i++) payloads.push_back("{\"n\":" + std::to_string(i) + "}");
+        params.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            auto& p = params[i];
+            p.event_type = i % 2 ? EventType::Track : EventType::Identify;
+            p.timestamp = 1700000000000 + i;
+            p.service = "api";
+            p.service_len = 3;
+            p.device_id = DEVICE;
+            if (i % 2 == 0) p.session_id = SESSION;
+            p.event_name = i % 2 ? "Page Viewed" : "Signed Up";
+            p.event_name_len = std::strlen(p.event_name);
+            if (i % 3 != 2) {
+                p.payload = reinterpret_cast<const uint8_t*>(payloads[i].data());
+                p.payload_len = payloads[i].size();
+            }
+        }
+    }
+};
+
+void expect_events(EventDataView data, const std::vector<EventParams>& params) {
+    auto events = data.events();
+    ASSERT_EQ(events.size(), params.size());
+    size_t i = 0;
+    for (auto e : events) {
+        const auto& p = params[i];
+        EXPECT_EQ(e.event_type(), p.event_type) << i;
+        EXPECT_EQ(e.timestamp(), p.timestamp) << i;
+        EXPECT_EQ(e.service(), "api") << i;
+        EXPECT_EQ(str(e.device_id()), std::string(reinterpret_cast<const char*>(DEVICE), 16)) << i;
+        EXPECT_EQ(static_cast<bool>(e.session_id()), p.session_id != nullptr) << i;
+        EXPECT_EQ(e.event_name(), std::string(p.event_name, p.event_name_len)) << i;
+        if (p.payload) {
+            EXPECT_EQ(str(e.payload()), std::string(reinterpret_cast<const char*>(p.payload), p.payload_len)) << i;
+        } else {
+            EXPECT_FALSE(e.payload()) << i;
+        }
+        i++;
+    }
+    EXPECT_EQ(events[1].timestamp(), params[1].timestamp);
+}
+
+} // namespace
+
+TEST(DecodingTest, EventFrameViews) {
+    SampleEvents events(10);
+    std::vector<uint8_t> frame;
+    encode_event_batch(frame, header(SchemaType::Event), events.params);
+
+    Verifier verifier(frame.data(), frame.size());
+    ASSERT_TRUE(verifier.batch()) << verifier.error();
+    auto batch = BatchView::root(frame.data());
+    EXPECT_EQ(str(batch.api_key()), std::string(reinterpret_cast<const char*>(API_KEY), 16));
+    EXPECT_EQ(batch.schema_type(), SchemaType::Event);
+    EXPECT_EQ(batch.version(), DEFAULT_VERSION);
+    EXPECT_EQ(batch.batch_id(), 42u);
+    EXPECT_EQ(batch.compression(), Compression::None);
+    expect_events(batch.event_data(), events.params);
+}
+
+TEST(DecodingTest, ReferenceEncoderFrameViews) {
+    SampleEvents events(5);
+    std::vector<uint8_t> data, frame;
+    encode_event_data_into(data, events.params);
+    auto bp = header(SchemaType::Event);
+    bp.batch_id = 0;  // absent
+    bp.data = data.data();
+    bp.data_len = data.size();
+    encode_batch_into(frame, bp);
+
+    ASSERT_TRUE(Verifier(frame.data(), frame.size()).batch());
+    auto batch = BatchView::root(frame.data());
+    EXPECT_EQ(batch.batch_id(), 0u);
+    EXPECT_EQ(batch.field(schema::batch::batch_id), nullptr);
+    expect_events(batch.event_data(), events.params);
+}
+
+TEST(DecodingTest, LogFrameViews) {
+    std::vector<LogEntryParams> logs(4);
+    for (size_t i = 0; i < logs.size(); i++) {
+        logs[i].level = static_cast<LogLevel>(i);
+        logs[i].timestamp = 100 + i;
+        logs[i].source = "host-1";
+        logs[i].source_len = 6;
+        if (i != 3) logs[i].session_id = SESSION;
+        logs[i].payload = reinterpret_cast<const uint8_t*>("{}");
+        logs[i].payload_len = 2;
+    }
+    logs[2].event_type = LogEventType::Enrich;
+    logs[2].service = "billing";
+    logs[2].service_len = 7;
+
+    std::vector<uint8_t> frame;
+    encode_log_batch(frame, header(SchemaType::Log), logs);
+    ASSERT_TRUE(Verifier(frame.data(), frame.size()).batch());
+
+    auto view = BatchView::root(frame.data()).log_data().logs();
+    ASSERT_EQ(view.size(), logs.size());
+    for (size_t i = 0; i < logs.size(); i++) {
+        auto l = view[i];
+        EXPECT_EQ(l.event_type(), logs[i].event_type);
+        EXPECT_EQ(l.level(), logs[i].level);
+        EXPECT_EQ(l.timestamp(), logs[i].timestamp);
+        EXPECT_EQ(l.source(), "host-1");
+        EXPECT_EQ(l.service(), i == 2 ? "billing" : "");
+        EXPECT_EQ(l.service().data() != nullptr, i == 2);
+        EXPECT_EQ(static_cast<bool>(l.session_id()), i != 3);
+        EXPECT_EQ(str(l.payload()), "{}");
+    }
+}
+
+TEST(DecodingTest, CompressedFrame) {
+    SampleEvents events(50);
+    std::vector<uint8_t> data, frame;
+    encode_event_data_exact(data, events.params);
+    auto bp = header(SchemaType::Event);
+    bp.data = data.data();
+    bp.data_len = data.size();
+    ASSERT_TRUE(encode_compressed_batch(frame, bp, Compression::Lz4));
+
+    ASSERT_TRUE(Verifier(frame.data(), frame.size()).batch());
+    auto batch = BatchView::root(frame.data());
+    EXPECT_EQ(batch.compression(), Compression::Lz4);
+
+    std::vector<uint8_t> raw;
+    ASSERT_TRUE(decompress_data(batch, raw));
+    EXPECT_EQ(raw, data);
+    ASSERT_TRUE(Verifier(raw.data(), raw.size()).event_data());
+    expect_events(EventDataView::root(raw.data()), events.params);
+}
+
+TEST(DecodingTest, CompressedFrameRejectsForgedSize) {
+    SampleEvents events(5);
+    std::vector<uint8_t> data, frame;
+    encode_event_data_exact(data, events.params);
+    auto bp = header(SchemaType::Event);
+    bp.data = data.data();
+    bp.data_len = data.size();
+    ASSERT_TRUE(encode_compressed_batch(frame, bp, Compression::Lz4));
+
+    // Claim a 4 GB raw size: rejected before anything is allocated
+    auto batch = BatchView::root(frame.data());
+    Bytes compressed = batch.data();
+    uint8_t* raw_len = frame.data() + (compressed.data - frame.data());
+    std::memset(raw_len, 0xff, 4);
+
+    Verifier verifier(frame.data(), frame.size());
+    EXPECT_FALSE(verifier.batch());
+    EXPECT_STREQ(verifier.error(), "compressed size too large");
+    std::vector<uint8_t> raw;
+    EXPECT_FALSE(decompress_data(batch, raw));
+    EXPECT_TRUE(raw.empty());
+}
+
+TEST(DecodingTest, VerifierRejectsTruncatedFrames) {
+    SampleEvents events(3);
+    std::vector<uint8_t> frame;
+    encode_event_batch(frame, header(SchemaType::Event), events.params);
+
+    for (size_t len = 0; len < frame.size(); len++) {
+        Verifier verifier(frame.data(), len);
+        EXPECT_FALSE(verifier.batch()) << len;
+        EXPECT_NE(verifier.error(), nullptr) << len;
+    }
+}
+
+TEST(DecodingTest, VerifierRejectsMalformedFields) {
+    SampleEvents events(1);
+    std::vector<uint8_t> data;
+    encode_event_data_exact(data, events.params);
+    ASSERT_TRUE(Verifier(data.data(), data.size()).event_data());
+
+    // Overwrite the byte `delta` bytes past the first occurrence of needle
+    auto corrupt = [&](const std::string& needle, std::ptrdiff_t delta, uint8_t value) {
+        auto bad = data;
+        auto it = std::search(bad.begin(), bad.end(), needle.begin(), needle.end());
+        EXPECT_NE(it, bad.end()) << needle;
+        if (it != bad.end()) *(it + delta) = value;
+        Verifier verifier(bad.data(), bad.size());
+        EXPECT_FALSE(verifier.event_data()) << needle;
+        return std::string(verifier.error() ? verifier.error() : "");
+    };
+
+    // Null terminator of the pooled event name
+    EXPECT_EQ(corrupt("Signed Up", 9, 'x'), "string not null-terminated");
+    // device_id length (the u32 before its 16 bytes)
+    EXPECT_EQ(corrupt(std::string(reinterpret_cast<const char*>(DEVICE), 16), -4, 15),
+              "fixed-size vector has the wrong length");
+    // A payload length reaching past the end
+    EXPECT_EQ(corrupt(events.payloads[0], -1, 0x7F), "vector contents out of bounds");
+}
+
+TEST(DecodingTest, VerifierSurvivesCorruptBytes) {
+    // Every single-byte corruption either verifies or is rejected; views are
+    // only walked over frames that verify
+    SampleEvents events(4);
+    std::vector<uint8_t> frame;
+    encode_event_batch(frame, header(SchemaType::Event), events.params);
+
+    for (size_t pos = 0; pos < frame.size(); pos++) {
+        for (uint8_t value : {uint8_t(0x00), uint8_t(0x7F), uint8_t(0xFF)}) {
+            auto bad = frame;
+            bad[pos] = value;
+            if (!Verifier(bad.data(), bad.size()).batch()) continue;
+            size_t total = 0;
+            for (auto e : BatchView::root(bad.data()).event_data().events()) {
+                total += e.payload().size + e.event_name().size() + e.service().size();
+            }
+            EXPECT_LE(total, bad.size());
+        }
+    }
+}
@@ -2,12 +2,96 @@
 // Unit tests for hand-written FlatBuffer encoding.
 
 #include <gtest/gtest.h>
+#include "decoding.hpp"
 #include "encoding.hpp"
 #include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
 
 using namespace tell;
 using namespace tell::encoding;
 
+namespace {
+
+using Field = std::optional<std::string>;
+
+Field field_of(const void* data, size_t len) {
+    if (!data) return std::nullopt;
+    return std::string(static_cast<const char*>(data), len);
+}
+
+struct DecodedEvent {
+    uint8_t type;
+    uint64_t timestamp;
+    Field device_id, session_id, service, name, payload;
+    bool operator==(const DecodedEvent& o) const {
+        return type == o.type && timestamp == o.timestamp && device_id == o.device_id &&
+               session_id == o.session_id && service == o.service && name == o.name &&
+               payload == o.payload;
+    }
+};
+
+struct DecodedLog {
+    uint8_t type, level;
+    uint64_t timestamp;
+    Field session_id, source, service, payload;
+    bool operator==(const DecodedLog& o) const {
+        return type == o.type && level == o.level && timestamp == o.timestamp &&
+               session_id == o.session_id && source == o.source && service == o.service &&
+               payload == o.payload;
+    }
+};
+
+DecodedEvent expected(const EventParams& p) {
+    return {static_cast<uint8_t>(p.event_type), p.timestamp,
+            field_of(p.device_id, UUID_LENGTH), field_of(p.session_id, UUID_LENGTH),
+            field_of(p.service, p.service_len), field_of(p.event_name, p.event_name_len),
+            p.payload_len > 0 ? field_of(p.payload, p.payload_len) : std::nullopt};
+}
+
+DecodedLog expected(const LogEntryParams& p) {
+    return {static_cast<uint8_t>(p.event_type), static_cast<uint8_t>(p.level), p.timestamp,
+            field_of(p.session_id, UUID_LENGTH), field_of(p.source, p.source_len),
+            field_of(p.service, p.service_len),
+            p.payload_len > 0 ? field_of(p.payload, p.payload_len) : std::nullopt};
+}
+
+Field field_of(decoding::Bytes b) { return b ? Field(std::string(b.str())) : std::nullopt; }
+Field field_of(std::string_view s) { return s.data() ? Field(std::string(s)) : std::nullopt; }
+
+// Decode EventData; returns nullopt if the buffer does not verify.
+std::optional<std::vector<DecodedEvent>> decode_events(const uint8_t* data, size_t len) {
+    if (!decoding::Verifier(data, len).event_data()) return std::nullopt;
+    std::vector<DecodedEvent> out;
+    for (auto e : decoding::EventDataView::root(data).events()) {
+        out.push_back({static_cast<uint8_t>(e.event_type()), e.timestamp(),
+                       field_of(e.device_id()), field_of(e.session_id()), field_of(e.service()),
+                       field_of(e.event_name()), field_of(e.payload())});
+    }
+    return out;
+}
+
+std::optional<std::vector<DecodedLog>> decode_logs(const uint8_t* data, size_t len) {
+    if (!decoding::Verifier(data, len).log_data()) return std::nullopt;
+    std::vector<DecodedLog> out;
+    for (auto l : decoding::LogDataView::root(data).logs()) {
+        out.push_back({static_cast<uint8_t>(l.event_type()), static_cast<uint8_t>(l.level()), l.timestamp(),
+                       field_of(l.session_id()), field_of(l.source()), field_of(l.service()),
+                       field_of(l.payload())});
+    }
+    return out;
+}
+
+// Data vector of a Batch frame, as {offset, length}; {0, 0} if it does not verify.
+std::pair<size_t, size_t> batch_data(const std::vector<uint8_t>& frame) {
+    if (!decoding::Verifier(frame.data(), frame.size()).batch()) return {0, 0};
+    auto data = decoding::BatchView::root(frame.data()).data();
+    return {static_cast<size_t>(data.data - frame.data()), data.size};
+}
+
+} // namespace
+
 TEST(EncodingTest, EventBasicStructure) {
     EventParams params;
     params.event_type = EventType::Track;
@@ -188,3 +272,473 @@ TEST(EncodingTest, BatchDefaultVersion) {
     encode_batch_into(buf, params);
     EXPECT_GT(buf.size(), 0u);
 }
+
+TEST(EncodingTest, EncodedEventSizeIsExact) {
+    uint8_t id[16] = {};
+    const char* json = "{\"url\":\"/home\"}";
+
+    for (int mask = 0; mask < 32; mask++) {
+        EventParams params;
+        params.event_type = EventType::Track;
+        params.timestamp = 1706000000000;
+        if (mask & 1) params.device_id = id;
+        if (mask & 2) params.session_id = id;
+        if (mask & 4) { params.service = "api"; params.service_len = 3; }
+        if (mask & 8) { params.event_name = "Page Viewed"; params.event_name_len = 11; }
+        if (mask & 16) {
+            params.payload = reinterpret_cast<const uint8_t*>(json);
+            params.payload_len = std::strlen(json);
+        }
+
+        std::vector<uint8_t> buf;
+        encode_event_into(buf, params);
+        EXPECT_EQ(buf.size(), encoded_event_size(params)) << "mask " << mask;
+    }
+}
+
+TEST(EncodingTest, EncodedLogEntrySizeIsExact) {
+    uint8_t id[16] = {};
+    const char* json = "{\"message\":\"disk full\"}";
+
+    for (int mask = 0; mask < 16; mask++) {
+        LogEntryParams params;
+        params.level = LogLevel::Error;
+        params.timestamp = 1706000000000;
+        if (mask & 1) params.session_id = id;
+        if (mask & 2) { params.source = "host-1"; params.source_len = 6; }
+        if (mask & 4) { params.service = "api"; params.service_len = 3; }
+        if (mask & 8) {
+            params.payload = reinterpret_cast<const uint8_t*>(json);
+            params.payload_len = std::strlen(json);
+        }
+
+        std::vector<uint8_t> buf;
+        encode_log_entry_into(buf, params);
+        EXPECT_EQ(buf.size(), encoded_log_entry_size(params)) << "mask " << mask;
+    }
+}
+
+TEST(EncodingTest, FrameSizeBoundCoversBatch) {
+    uint8_t api_key[16] = {};
+    const char* json = "{\"n\":12345}";
+
+    std::vector<LogEntryParams> logs(5);
+    size_t bound = BATCH_OVERHEAD + DATA_OVERHEAD;
+    for (size_t i = 0; i < logs.size(); i++) {
+        logs[i].timestamp = i;
+        logs[i].payload = reinterpret_cast<const uint8_t*>(json);
+        logs[i].payload_len = std::strlen(json) - i; // vary the padding
+        bound += data_entry_size(encoded_log_entry_size(logs[i]));
+    }
+
+    std::vector<uint8_t> data;
+    encode_log_data_into(data, logs);
+
+    BatchParams bp;
+    bp.api_key = api_key;
+    bp.schema_type = SchemaType::Log;
+    bp.batch_id = 7;
+    bp.data = data.data();
+    bp.data_len = data.size();
+    std::vector<uint8_t> frame;
+    encode_batch_into(frame, bp);
+
+    EXPECT_EQ(frame.size(), BATCH_OVERHEAD + data.size());
+    EXPECT_LE(frame.size(), bound);
+    EXPECT_GT(frame.size() + 4, bound); // only the last entry's padding is slack
+}
+
+TEST(EncodingTest, ExactEncodersMatchReference) {
+    uint8_t id[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    uint8_t api_key[16] = {};
+    const char* json = "{\"url\":\"/home\",\"n\":1}";
+
+    // Every field-presence combination, with payloads off a 4-byte boundary
+    std::vector<EventParams> events;
+    for (int mask = 0; mask < 32; mask++) {
+        EventParams params;
+        params.event_type = EventType::Track;
+        params.timestamp = 1706000000000 + mask;
+        if (mask & 1) params.device_id = id;
+        if (mask & 2) params.session_id = id;
+        if (mask & 4) { params.service = "api"; params.service_len = 3; }
+        if (mask & 8) { params.event_name = "Page Viewed"; params.event_name_len = 11; }
+        if (mask & 16) {
+            params.payload = reinterpret_cast<const uint8_t*>(json);
+            params.payload_len = std::strlen(json) - (mask % 4);
+        }
+        events.push_back(params);
+
+        std::vector<uint8_t> ref, exact;
+        encode_event_into(ref, params);
+        encode_event_exact(exact, params);
+        EXPECT_EQ(ref, exact) << "mask " << mask;
+    }
+
+    std::vector<LogEntryParams> logs;
+    for (int mask = 0; mask < 16; mask++) {
+        LogEntryParams params;
+        params.level = LogLevel::Warning;
+        params.timestamp = 1706000000000 + mask;
+        if (mask & 1) params.session_id = id;
+        if (mask & 2) { params.source = "host-1"; params.source_len = 6; }
+        if (mask & 4) { params.service = "api"; params.service_len = 3; }
+        if (mask & 8) {
+            params.payload = reinterpret_cast<const uint8_t*>(json);
+            params.payload_len = std::strlen(json) - (mask % 4);
+        }
+        logs.push_back(params);
+
+        std::vector<uint8_t> ref, exact;
+        encode_log_entry_into(ref, params);
+        encode_log_entry_exact(exact, params);
+        EXPECT_EQ(ref, exact) << "mask " << mask;
+    }
+
+    std::vector<uint8_t> ref_events, exact_events, ref_logs, exact_logs;
+    encode_event_data_into(ref_events, events);
+    encode_event_data_exact(exact_events, events);
+    encode_log_data_into(ref_logs, logs);
+    encode_log_data_exact(exact_logs, logs);
+    // EventData/LogData share vtables, so compare decoded records instead
+    ASSERT_TRUE(decode_events(exact_events.data(), exact_events.size()).has_value());
+    ASSERT_TRUE(decode_logs(exact_logs.data(), exact_logs.size()).has_value());
+    EXPECT_EQ(decode_events(ref_events.data(), ref_events.size()),
+              decode_events(exact_events.data(), exact_events.size()));
+    EXPECT_EQ(decode_logs(ref_logs.data(), ref_logs.size()),
+              decode_logs(exact_logs.data(), exact_logs.size()));
+    EXPECT_EQ(exact_events.size(), encoded_event_data_size(events));
+    EXPECT_EQ(exact_logs.size(), encoded_log_data_size(logs));
+
+    for (uint64_t batch_id : {uint64_t(0), uint64_t(42)}) {
+        BatchParams bp;
+        bp.api_key = api_key;
+        bp.schema_type = SchemaType::Event;
+        bp.batch_id = batch_id;
+        bp.data = ref_events.data();
+        bp.data_len = ref_events.size() - 1; // unaligned data vector
+        std::vector<uint8_t> ref, exact;
+        encode_batch_into(ref, bp);
+        encode_batch_exact(exact, bp);
+        EXPECT_EQ(ref, exact) << "batch_id " << batch_id;
+    }
+}
+
+TEST(EncodingTest, NestedBatchMatchesTwoPass) {
+    uint8_t id[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    uint8_t api_key[16] = {0xA1};
+    const char* json = "{\"url\":\"/home\",\"n\":1}";
+
+    std::vector<EventParams> events(4);
+    std::vector<LogEntryParams> logs(4);
+    for (size_t i = 0; i < 4; i++) {
+        events[i].event_type = EventType::Track;
+        events[i].timestamp = 1000 + i;
+        events[i].device_id = id;
+        events[i].event_name = "Page Viewed";
+        events[i].event_name_len = 11 - i;
+        events[i].payload = reinterpret_cast<const uint8_t*>(json);
+        events[i].payload_len = std::strlen(json) - i;
+        logs[i].timestamp = 2000 + i;
+        logs[i].session_id = id;
+        logs[i].source = "host-1";
+        logs[i].source_len = 6 - i;
+        logs[i].payload = reinterpret_cast<const uint8_t*>(json);
+        logs[i].payload_len = std::strlen(json) - i;
+    }
+
+    auto two_pass = [&](const std::vector<uint8_t>& data, SchemaType schema) {
+        BatchParams bp;
+        bp.api_key = api_key;
+        bp.schema_type = schema;
+        bp.batch_id = 9;
+        bp.data = data.data();
+        bp.data_len = data.size();
+        std::vector<uint8_t> frame;
+        encode_batch_into(frame, bp);
+        return frame;
+    };
+
+    BatchParams header;
+    header.api_key = api_key;
+    header.batch_id = 9;
+
+    std::vector<uint8_t> event_data, event_frame;
+    encode_event_data_exact(event_data, events);
+    header.schema_type = SchemaType::Event;
+    encode_event_batch(event_frame, header, events);
+    EXPECT_EQ(event_frame, two_pass(event_data, SchemaType::Event));
+
+    std::vector<uint8_t> log_data, log_frame;
+    encode_log_data_exact(log_data, logs);
+    header.schema_type = SchemaType::Log;
+    encode_log_batch(log_frame, header, logs);
+    EXPECT_EQ(log_frame, two_pass(log_data, SchemaType::Log));
+
+    // Pre-encoded tables keep their strings inline but decode the same
+    std::vector<std::vector<uint8_t>> encoded(events.size());
+    std::vector<EncodedTable> tables;
+    for (size_t i = 0; i < events.size(); i++) {
+        encode_event_exact(encoded[i], events[i]);
+        tables.push_back({encoded[i].data(), encoded[i].size()});
+    }
+    std::vector<uint8_t> table_frame;
+    header.schema_type = SchemaType::Event;
+    encode_event_tables_batch(table_frame, header, tables);
+    auto table_data = batch_data(table_frame);
+    auto event_data_span = batch_data(event_frame);
+    ASSERT_GT(table_data.second, 0u);
+    auto from_tables = decode_events(table_frame.data() + table_data.first, table_data.second);
+    ASSERT_TRUE(from_tables.has_value());
+    EXPECT_EQ(from_tables, decode_events(event_frame.data() + event_data_span.first, event_data_span.second));
+}
+
+TEST(EncodingTest, SharedVTablesDecode) {
+    uint8_t id[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    uint8_t api_key[16] = {0xA1};
+    const char* json = "{\"url\":\"/home\",\"n\":1}";
+
+    // Mostly one field-presence pattern, with a few others mixed in
+    std::vector<EventParams> events(50);
+    for (size_t i = 0; i < events.size(); i++) {
+        auto& e = events[i];
+        e.event_type = i % 7 == 0 ? EventType::Identify : EventType::Track;
+        e.timestamp = 1706000000000 + i;
+        e.device_id = id;
+        e.session_id = i % 10 == 3 ? nullptr : id;
+        e.service = "api";
+        e.service_len = 3;
+        e.event_name = i % 2 ? "Page Viewed" : "Feature Used";
+        e.event_name_len = std::strlen(e.event_name);
+        e.payload = reinterpret_cast<const uint8_t*>(json);
+        e.payload_len = i % 13 == 5 ? 0 : std::strlen(json) - i % 4;
+    }
+
+    std::vector<LogEntryParams> logs(20);
+    for (size_t i = 0; i < logs.size(); i++) {
+        auto& l = logs[i];
+        l.level = i % 3 ? LogLevel::Info : LogLevel::Error;
+        l.timestamp = 1706000000000 + i;
+        l.session_id = id;
+        l.source = i % 5 == 0 ? nullptr : "host-1";
+        l.source_len = 6;
+        l.service = "api";
+        l.service_len = 3;
+        l.payload = reinterpret_cast<const uint8_t*>(json);
+        l.payload_len = std::strlen(json) - i % 4;
+    }
+
+    BatchParams header;
+    header.api_key = api_key;
+    header.batch_id = 3;
+
+    std::vector<uint8_t> frame, reference;
+    header.schema_type = SchemaType::Event;
+    encode_event_batch(frame, header, events);
+    encode_event_data_into(reference, events);
+
+    auto data = batch_data(frame);
+    ASSERT_GT(data.second, 0u);
+    auto decoded = decode_events(frame.data() + data.first, data.second);
+    ASSERT_TRUE(decoded.has_value());
+    ASSERT_EQ(decoded->size(), events.size());
+    for (size_t i = 0; i < events.size(); i++) {
+        EXPECT_EQ((*decoded)[i], expected(events[i])) << "event " << i;
+    }
+    // Three presence patterns: every entry drops its root offset and vtable,
+    // and three shared vtables are written once. Of the 100 strings only
+    // "api", "Page Viewed" and "Feature Used" are written, in the pool.
+    size_t inline_strings = events.size() * string_size(3) +
+                            events.size() / 2 * (string_size(11) + string_size(12));
+    size_t pool = string_size(3) + string_size(11) + string_size(12);
+    EXPECT_EQ(reference.size() - data.second,
+              events.size() * ENTRY_ROOT_OFFSET - 3 * ENTRY_VTABLE_BYTES + inline_strings - pool);
+
+    frame.clear();
+    header.schema_type = SchemaType::Log;
+    encode_log_batch(frame, header, logs);
+    data = batch_data(frame);
+    ASSERT_GT(data.second, 0u);
+    auto decoded_logs = decode_logs(frame.data() + data.first, data.second);
+    ASSERT_TRUE(decoded_logs.has_value());
+    ASSERT_EQ(decoded_logs->size(), logs.size());
+    for (size_t i = 0; i < logs.size(); i++) {
+        EXPECT_EQ((*decoded_logs)[i], expected(logs[i])) << "log " << i;
+    }
+}
+
+TEST(EncodingTest, StringPoolWritesEachStringOnce) {
+    const char* names[] = {"Page Viewed", "Feature Used", "Signed Up"};
+    std::string service = "checkout-api";
+
+    // Equal contents from different buffers must pool too
+    std::vector<std::string> copies(90);
+    std::vector<EventParams> events(copies.size());
+    for (size_t i = 0; i < events.size(); i++) {
+        copies[i] = names[i % 3];
+        events[i].event_type = EventType::Track;
+        events[i].timestamp = i;
+        events[i].service = service.c_str();
+        events[i].service_len = service.size();
+        events[i].event_name = copies[i].c_str();
+        events[i].event_name_len = copies[i].size();
+    }
+    events[7].event_name = nullptr;  // absent field stays absent
+
+    std::vector<uint8_t> buf;
+    encode_event_data_exact(buf, events);
+    EXPECT_EQ(buf.size(), encoded_event_data_size(events));
+
+    auto count = [&](const std::string& needle) {
+        std::string hay(buf.begin(), buf.end());
+        size_t n = 0;
+        for (size_t pos = hay.find(needle); pos != std::string::npos; pos = hay.find(needle, pos + 1)) n++;
+        return n;
+    };
+    EXPECT_EQ(count("checkout-api"), 1u);
+    for (const char* name : names) EXPECT_EQ(count(name), 1u) << name;
+
+    auto decoded = decode_events(buf.data(), buf.size());
+    ASSERT_TRUE(decoded.has_value());
+    ASSERT_EQ(decoded->size(), events.size());
+    for (size_t i = 0; i < events.size(); i++) {
+        EXPECT_EQ((*decoded)[i], expected(events[i])) << "event " << i;
+    }
+}
+
+TEST(EncodingTest, GatherFrameMatchesTwoPass) {
+    uint8_t id[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    uint8_t api_key[16] = {0xA1};
+    std::vector<uint8_t> large(1024), medium(GATHER_MIN_BYTES + 3), small(GATHER_MIN_BYTES);
+    for (size_t i = 0; i < large.size(); i++) large[i] = static_cast<uint8_t>(i * 7);
+    std::fill(medium.begin(), medium.end(), 'm');
+    std::fill(small.begin(), small.end(), 's');
+    const std::vector<uint8_t>* payloads[] = {&large, &small, nullptr, &medium, &large};
+
+    std::vector<EventParams> events(5);
+    std::vector<LogEntryParams> logs(5);
+    for (size_t i = 0; i < 5; i++) {
+        events[i].event_type = EventType::Track;
+        events[i].device_id = id;
+        events[i].event_name = i % 2 ? "Signed Up" : "Page Viewed";
+        events[i].event_name_len = std::strlen(events[i].event_name);
+        logs[i].session_id = id;
+        logs[i].source = "host-1";
+        logs[i].source_len = 6;
+        if (payloads[i]) {
+            events[i].payload = logs[i].payload = payloads[i]->data();
+            events[i].payload_len = logs[i].payload_len = payloads[i]->size() - i;
+        }
+    }
+
+    BatchParams header;
+    header.api_key = api_key;
+    header.batch_id = 3;
+
+    // Reference frame: the data encoded on its own, then wrapped in a batch
+    auto two_pass = [&](const std::vector<uint8_t>& data) {
+        BatchParams bp = header;
+        bp.data = data.data();
+        bp.data_len = data.size();
+        std::vector<uint8_t> frame;
+        encode_batch_exact(frame, bp);
+        return frame;
+    };
+
+    // Large payloads are referenced in place; everything else is in head
+    auto check = [](const GatherFrame& frame, const std::vector<uint8_t>& nested, size_t referenced) {
+        EXPECT_EQ(frame.flatten(), nested);
+        size_t outside = 0;
+        for (const auto& s : frame.segments) {
+            bool in_head = s.data >= frame.head.data() && s.data + s.len <= frame.head.data() + frame.head.size();
+            if (!in_head) outside += s.len;
+        }
+        EXPECT_EQ(outside, referenced);
+        EXPECT_EQ(frame.head.size() + referenced, nested.size());
+    };
+    size_t referenced = large.size() + GATHER_MIN_BYTES + (large.size() - 4);
+
+    GatherFrame frame;
+    std::vector<uint8_t> data;
+    header.schema_type = SchemaType::Event;
+    gather_event_batch(frame, header, events);
+    encode_event_data_exact(data, events);
+    check(frame, two_pass(data), referenced);
+
+    header.schema_type = SchemaType::Log;
+    gather_log_batch(frame, header, logs);
+    data.clear();
+    encode_log_data_exact(data, logs);
+    check(frame, two_pass(data), referenced);
+
+    // Producer-encoded tables go out whole when large enough
+    std::vector<std::vector<uint8_t>> encoded(events.size());
+    std::vector<EncodedTable> tables;
+    size_t table_bytes = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        encode_event_exact(encoded[i], events[i]);
+        tables.push_back({encoded[i].data(), encoded[i].size()});
+        table_bytes += gathered_size(encoded[i].size() - ENTRY_ROOT_OFFSET - 4);
+    }
+    header.schema_type = SchemaType::Event;
+    gather_event_tables_batch(frame, header, tables);
+    data.clear();
+    encode_data_exact<TableEntries>(data, tables);
+    check(frame, two_pass(data), table_bytes);
+}
+
+TEST(EncodingTest, CompressedBatchRoundTrips) {
+    uint8_t id[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    uint8_t api_key[16] = {0xA1};
+    std::vector<std::string> payloads;
+    for (int i = 0; i < 50; i++) {
+        payloads.push_back("{\"url\":\"/page/" + std::to_string(i % 7) + "\",\"referrer\":\"https://example.com\"}");
+    }
+    std::vector<EventParams> events(payloads.size());
+    for (size_t i = 0; i < events.size(); i++) {
+        events[i].event_type = EventType::Track;
+        events[i].timestamp = 1700000000000 + i;
+        events[i].device_id = id;
+        events[i].event_name = "Page Viewed";
+        events[i].event_name_len = 11;
+        events[i].payload = reinterpret_cast<const uint8_t*>(payloads[i].data());
+        events[i].payload_len = payloads[i].size();
+    }
+    std::vector<uint8_t> data;
+    encode_event_data_exact(data, events);
+
+    BatchParams header;
+    header.api_key = api_key;
+    header.schema_type = SchemaType::Event;
+    header.batch_id = 5;
+    header.data = data.data();
+    header.data_len = data.size();
+
+    std::vector<uint8_t> frame;
+    ASSERT_TRUE(encode_compressed_batch(frame, header, Compression::Lz4));
+    EXPECT_LT(frame.size(), BATCH_OVERHEAD + data.size());
+
+    ASSERT_TRUE(decoding::Verifier(frame.data(), frame.size()).batch());
+    auto batch = decoding::BatchView::root(frame.data());
+    EXPECT_EQ(batch.compression(), Compression::Lz4);
+    EXPECT_EQ(batch.batch_id(), 5u);
+    EXPECT_EQ(batch.schema_type(), SchemaType::Event);
+    auto packed = batch.data();
+    ASSERT_GT(packed.size, 4u);
+
+    uint32_t raw_len;
+    std::memcpy(&raw_len, packed.data, 4);
+    ASSERT_EQ(raw_len, data.size());
+    std::vector<uint8_t> raw(raw_len);
+    ASSERT_TRUE(lz4::decompress(packed.data + 4, packed.size - 4, raw.data(), raw.size()));
+    EXPECT_EQ(raw, data);
+
+    // Data that would not shrink goes out as the plain frame
+    std::vector<uint8_t> tiny = {1, 2, 3, 4}, plain, fallback;
+    header.data = tiny.data();
+    header.data_len = tiny.size();
+    encode_batch_exact(plain, header);
+    EXPECT_FALSE(encode_compressed_batch(fallback, header, Compression::Lz4));
+    EXPECT_EQ(fallback, plain);
+    EXPECT_EQ(decoding::BatchView::root(fallback.data()).field(schema::batch::compression), nullptr);
+}
@@ -0,0 +1,92 @@
+// tests/json_escape_test.cpp
+// Unit tests for the shared JSON string escaper and its SIMD scanners.
+
+#include <gtest/gtest.h>
+#include "tell/json_escape.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace tell::json;
+
+namespace {
+
+std::string escape(const std::string& s) {
+    std::vector<uint8_t> buf;
+    append_escaped(buf, s.data(), s.size());
+    return std::string(buf.begin(), buf.end());
+}
+
+// Every finder available on this machine, checked against the scalar one.
+template <typename Check>
+void for_each_finder(Check check) {
+    check("dispatch", &find_escape);
+    check("scalar", &detail::find_escape_scalar);
+#if TELL_JSON_SSE2
+    check("sse2", &detail::find_escape_sse2);
+#endif
+#if TELL_JSON_AVX2
+    if (detail::has_avx2()) check("avx2", &detail::find_escape_avx2);
+#endif
+}
+
+} // namespace
+
+TEST(JsonEscapeTest, ShortForms) {
+    EXPECT_EQ(escape("plain"), "plain");
+    EXPECT_EQ(escape(""), "");
+    EXPECT_EQ(escape("a\"b\\c"), "a\\\"b\\\\c");
+    EXPECT_EQ(escape("\b\f\n\r\t"), "\\b\\f\\n\\r\\t");
+}
+
+TEST(JsonEscapeTest, ControlBytesUseUnicodeEscapes) {
+    EXPECT_EQ(escape(std::string(1, '\0')), "\\u0000");
+    EXPECT_EQ(escape("\x01\x1f"), "\\u0001\\u001f");
+    EXPECT_EQ(escape("\x0b"), "\\u000b");
+    // 0x7F and UTF-8 pass through unchanged
+    EXPECT_EQ(escape("\x7f"), "\x7f");
+    EXPECT_EQ(escape("caf\xc3\xa9 \xe2\x9c\x93"), "caf\xc3\xa9 \xe2\x9c\x93");
+}
+
+TEST(JsonEscapeTest, FindersAgreeAtEveryPosition) {
+    // One special byte at each position of strings spanning several 16- and
+    // 32-byte blocks, and the start offset moved across a block boundary
+    const char specials[] = {'"', '\\', '\0', '\n', 0x1F};
+    for (size_t len = 0; len <= 100; len += 3) {
+        for (size_t pos = 0; pos <= len; pos++) {
+            for (char special : specials) {
+                std::string s(len, 'x');
+                if (pos < len) s[pos] = special;
+                for (size_t start = 0; start <= 33 && start <= len; start += 11) {
+                    size_t expected = detail::find_escape_scalar(s.data(), start, len);
+                    for_each_finder([&](const char* name, size_t (*find)(const char*, size_t, size_t)) {
+                        EXPECT_EQ(find(s.data(), start, len), expected)
+                            << name << " len=" << len << " pos=" << pos << " start=" << start;
+                    });
+                }
+            }
+        }
+    }
+}
+
+TEST(JsonEscapeTest, HighBytesAreNotControls) {
+    // Bytes >= 0x80 are negative as signed char; none of them may match
+    std::string s;
+    for (int c = 0x20; c < 0x100; c++) {
+        if (c != '"' && c != '\\') s.push_back(static_cast<char>(c));
+    }
+    for_each_finder([&](const char* name, size_t (*find)(const char*, size_t, size_t)) {
+        EXPECT_EQ(find(s.data(), 0, s.size()), s.size()) << name;
+    });
+    EXPECT_EQ(escape(s), s);
+}
+
+TEST(JsonEscapeTest, LongMessage) {
+    std::string line(200, 'm');
+    std::string message, expected;
+    for (int i = 0; i < 300; i++) {
+        message += line + "\n\t\"quoted\" C:\\path";
+        expected += line + "\\n\\t\\\"quoted\\\" C:\\\\path";
+    }
+    EXPECT_EQ(escape(message), expected);
+}
@@ -0,0 +1,88 @@
+// tests/linger_test.cpp
+// Unit tests for the adaptive linger scheduler.
+
+#include <gtest/gtest.h>
+#include "linger.hpp"
+
+using namespace tell;
+using namespace std::chrono;
+
+namespace {
+
+// Feed `count` single arrivals spaced `gap` apart, starting at t0.
+AdaptiveLinger::clock::time_point feed(AdaptiveLinger& linger, AdaptiveLinger::clock::time_point t0,
+                                       nanoseconds gap, size_t count) {
+    auto t = t0;
+    for (size_t i = 0; i < count; i++) {
+        linger.on_arrival(t, 1);
+        t += gap;
+    }
+    return t;
+}
+
+} // namespace
+
+TEST(LingerTest, IdleHasNoDeadline) {
+    AdaptiveLinger linger(milliseconds(100), 1, 100);
+    EXPECT_FALSE(linger.due(AdaptiveLinger::clock::now()));
+    EXPECT_EQ(linger.deadline(), AdaptiveLinger::clock::time_point::max());
+}
+
+TEST(LingerTest, LowRateFlushesImmediately) {
+    AdaptiveLinger linger(milliseconds(100), 1, 100);
+    auto t0 = AdaptiveLinger::clock::now();
+    feed(linger, t0, milliseconds(100), 20); // 10 records/s
+    EXPECT_EQ(linger.target_batch(), 1u);
+    EXPECT_TRUE(linger.due(t0));
+}
+
+TEST(LingerTest, HighRateGrowsBatch) {
+    AdaptiveLinger linger(milliseconds(100), 1, 1000);
+    linger.on_send(microseconds(500));
+    auto t0 = AdaptiveLinger::clock::now();
+    auto t = feed(linger, t0, microseconds(10), 20000); // 100k records/s
+    linger.on_flush(linger.pending(), t);
+
+    size_t target = linger.target_batch();
+    EXPECT_GT(target, 50u);
+    EXPECT_LE(target, 1000u);
+
+    linger.on_arrival(t, 1);
+    EXPECT_FALSE(linger.due(t));
+    EXPECT_TRUE(linger.due(t + milliseconds(100)));
+}
+
+TEST(LingerTest, TargetClampedToMaxBatch) {
+    AdaptiveLinger linger(milliseconds(100), 1, 10);
+    linger.on_send(milliseconds(5));
+    feed(linger, AdaptiveLinger::clock::now(), microseconds(1), 50000);
+    EXPECT_EQ(linger.target_batch(), 10u);
+}
+
+TEST(LingerTest, MinBatchWaitsUntilMaxLatency) {
+    AdaptiveLinger linger(milliseconds(50), 10, 100);
+    auto t0 = AdaptiveLinger::clock::now();
+    linger.on_arrival(t0, 3);
+    EXPECT_FALSE(linger.due(t0 + milliseconds(49)));
+    EXPECT_TRUE(linger.due(t0 + milliseconds(50)));
+
+    linger.on_flush(3, t0 + milliseconds(50));
+    EXPECT_FALSE(linger.due(t0 + seconds(1)));
+}
+
+TEST(LingerTest, PartialFlushLeavesOnlyTheTail) {
+    AdaptiveLinger linger(milliseconds(50), 10, 100);
+    auto t0 = AdaptiveLinger::clock::now();
+    linger.on_arrival(t0, 13);
+    EXPECT_TRUE(linger.due(t0));
+
+    // A batch of 10 went out on its own: the 3 left wait for more
+    linger.on_flush(10, t0 + milliseconds(1));
+    EXPECT_EQ(linger.pending(), 3u);
+    EXPECT_FALSE(linger.due(t0 + milliseconds(1)));
+    EXPECT_FALSE(linger.due(t0 + milliseconds(50)));
+    EXPECT_TRUE(linger.due(t0 + milliseconds(51)));
+
+    linger.on_flush(5, t0 + milliseconds(51));
+    EXPECT_EQ(linger.pending(), 0u);
+}
@@ -0,0 +1,108 @@
+// tests/lz4_test.cpp
+// Unit tests for the LZ4 block codec.
+
+#include <gtest/gtest.h>
+#include "lz4.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace tell;
+
+namespace {
+
+std::vector<uint8_t> compress(const std::vector<uint8_t>& in) {
+    std::vector<uint8_t> out(lz4::bound(in.size()));
+    out.resize(lz4::compress(in.data(), in.size(), out.data()));
+    return out;
+}
+
+std::vector<uint8_t> round_trip(const std::vector<uint8_t>& in) {
+    auto packed = compress(in);
+    std::vector<uint8_t> out(in.size());
+    EXPECT_TRUE(lz4::decompress(packed.data(), packed.size(), out.data(), out.size()));
+    return out;
+}
+
+std::vector<uint8_t> bytes(const std::string& s) { return {s.begin(), s.end()}; }
+
+} // namespace
+
+TEST(Lz4Test, ShortInputIsOneLiteralRun) {
+    EXPECT_EQ(compress(bytes("abc")), (std::vector<uint8_t>{0x30, 'a', 'b', 'c'}));
+    EXPECT_EQ(compress({}), (std::vector<uint8_t>{0x00}));
+}
+
+TEST(Lz4Test, DecodesReferenceBlock) {
+    // 1 literal, then a 5-byte match at offset 1 (overlapping), then 5 literals
+    std::vector<uint8_t> block = {0x11, 'a', 0x01, 0x00, 0x50, 'b', 'b', 'b', 'b', 'b'};
+    std::vector<uint8_t> out(11);
+    ASSERT_TRUE(lz4::decompress(block.data(), block.size(), out.data(), out.size()));
+    EXPECT_EQ(out, bytes("aaaaaabbbbb"));
+}
+
+TEST(Lz4Test, RoundTripsEveryShortLength) {
+    // Covers the MF_LIMIT / LAST_LITERALS edges and nibble overflow at 15
+    for (size_t n = 0; n < 300; n++) {
+        std::vector<uint8_t> repeated(n), mixed(n);
+        for (size_t i = 0; i < n; i++) {
+            repeated[i] = static_cast<uint8_t>('a' + i % 3);
+            mixed[i] = static_cast<uint8_t>(i * 131 + (i >> 3));
+        }
+        EXPECT_EQ(round_trip(repeated), repeated) << n;
+        EXPECT_EQ(round_trip(mixed), mixed) << n;
+    }
+}
+
+TEST(Lz4Test, CompressesRepetitiveJson) {
+    std::string json;
+    for (int i = 0; i < 2000; i++) {
+        json += "{\"url\":\"/page/" + std::to_string(i % 37) + "\",\"user\":\"user_" +
+                std::to_string(i * 7919 % 1000) + "\"}";
+    }
+    auto in = bytes(json);
+    EXPECT_LT(compress(in).size(), in.size() / 3);
+    EXPECT_EQ(round_trip(in), in);
+}
+
+TEST(Lz4Test, IncompressibleStaysWithinBound) {
+    std::mt19937 rng(7);
+    std::vector<uint8_t> in(100000);
+    for (auto& b : in) b = static_cast<uint8_t>(rng());
+    auto packed = compress(in);
+    EXPECT_LE(packed.size(), lz4::bound(in.size()));
+    EXPECT_EQ(round_trip(in), in);
+}
+
+TEST(Lz4Test, LongMatchesAndFarOffsets) {
+    // Runs longer than 255 + 15 bytes, and repeats just inside and past the
+    // 64 KB window
+    std::mt19937 rng(11);
+    std::vector<uint8_t> in(200000);
+    for (size_t i = 0; i < in.size(); i++) {
+        if (i >= 65535 && i % 70000 < 1000) in[i] = in[i - 65535];
+        else if (i % 5000 < 600) in[i] = 'x';
+        else in[i] = static_cast<uint8_t>(rng());
+    }
+    EXPECT_EQ(round_trip(in), in);
+}
+
+TEST(Lz4Test, RejectsMalformedInput) {
+    auto in = bytes("hello hello hello hello hello hello");
+    auto packed = compress(in);
+    std::vector<uint8_t> out(in.size());
+
+    // Truncated input
+    EXPECT_FALSE(lz4::decompress(packed.data(), packed.size() - 1, out.data(), out.size()));
+    // Wrong expected size, either way
+    EXPECT_FALSE(lz4::decompress(packed.data(), packed.size(), out.data(), out.size() - 1));
+    std::vector<uint8_t> larger(in.size() + 1);
+    EXPECT_FALSE(lz4::decompress(packed.data(), packed.size(), larger.data(), larger.size()));
+    // Offset reaching before the start of the output
+    std::vector<uint8_t> bad = {0x10, 'a', 0x05, 0x00, 0x50, 'b', 'b', 'b', 'b', 'b'};
+    EXPECT_FALSE(lz4::decompress(bad.data(), bad.size(), out.data(), 11));
+    // Zero offset
+    bad[2] = 0x00;
+    EXPECT_FALSE(lz4::decompress(bad.data(), bad.size(), out.data(), 11));
+}
@@ -3,7 +3,10 @@
 
 #include <gtest/gtest.h>
 #include "tell/props.hpp"
+#include <cmath>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 using namespace tell;
 
@@ -78,6 +81,112 @@ TEST(PropsTest, NegativeInteger) {
     EXPECT_EQ(json, R"({"offset":-5})");
 }
 
+TEST(PropsTest, IntegerLimits) {
+    Props p;
+    p.add("min", INT64_MIN).add("max", UINT64_MAX).add("int", -2147483647 - 1);
+    auto bytes = p.to_json_bytes();
+    std::string json(bytes.begin(), bytes.end());
+    EXPECT_EQ(json, R"({"min":-9223372036854775808,"max":18446744073709551615,"int":-2147483648})");
+}
+
+TEST(PropsTest, DoubleRoundTrips) {
+    Props p;
+    p.add("a", 0.1).add("b", 1234567.891).add("c", 3.0).add("d", -2.5e-8).add("e", 1e300);
+    auto bytes = p.to_json_bytes();
+    std::string json(bytes.begin(), bytes.end());
+    // %g used to write 1.23457e+06 for b
+    EXPECT_EQ(json, R"({"a":0.1,"b":1234567.891,"c":3,"d":-2.5e-08,"e":1e+300})");
+}
+
+TEST(PropsTest, FloatUsesShortestFloatDigits) {
+    Props p;
+    p.add("f", 0.1f);
+    auto bytes = p.to_json_bytes();
+    std::string json(bytes.begin(), bytes.end());
+    EXPECT_EQ(json, R"({"f":0.1})");
+}
+
+TEST(PropsTest, FixedDecimals) {
+    Props p;
+    p.add("price", 49.9, 2).add("rate", 0.123456, 3).add("whole", 7.6, 0).add("neg", -1.0, 1);
+    auto bytes = p.to_json_bytes();
+    std::string json(bytes.begin(), bytes.end());
+    EXPECT_EQ(json, R"({"price":49.90,"rate":0.123,"whole":8,"neg":-1.0})");
+}
+
+TEST(PropsTest, NonFiniteIsNull) {
+    Props p;
+    p.add("nan", std::nan("")).add("inf", HUGE_VAL).add("fixed", -HUGE_VAL, 2);
+    auto bytes = p.to_json_bytes();
+    std::string json(bytes.begin(), bytes.end());
+    EXPECT_EQ(json, R"({"nan":null,"inf":null,"fixed":null})");
+}
+
+TEST(PropsTest, JsonViewAndRaw) {
+    Props p;
+    EXPECT_EQ(p.json(), "{}");
+    EXPECT_EQ(p.raw(), "");
+    p.add("a", 1).add("b", "x");
+    EXPECT_EQ(p.json(), R"({"a":1,"b":"x"})");
+    EXPECT_EQ(p.raw(), R"("a":1,"b":"x")");
+    auto bytes = p.to_json_bytes();
+    EXPECT_EQ(std::string(bytes.begin(), bytes.end()), std::string(p.json()));
+}
+
+TEST(PropsTest, SpillsPastInlineStorage) {
+    Props p;
+    std::string expected = "{";
+    for (int i = 0; i < 100; i++) {
+        std::string key = "key_" + std::to_string(i);
+        p.add(key, i);
+        expected += (i ? "," : "") + ("\"" + key + "\":" + std::to_string(i));
+    }
+    expected += "}";
+    ASSERT_GT(expected.size(), Props::INLINE_BYTES);
+    EXPECT_EQ(p.json(), expected);
+
+    // A long value crossing the boundary in one write
+    Props q;
+    q.add("short", 1).add("long", std::string(Props::INLINE_BYTES * 3, 'v'));
+    EXPECT_EQ(q.json(), R"({"short":1,"long":")" + std::string(Props::INLINE_BYTES * 3, 'v') + "\"}");
+}
+
+TEST(PropsTest, CopyAndMove) {
+    Props small;
+    small.add("url", "/home");
+    Props big;
+    for (int i = 0; i < 50; i++) big.add("field_" + std::to_string(i), "value");
+    const std::string small_json(small.json());
+    const std::string big_json(big.json());
+
+    for (Props* source : {&small, &big}) {
+        const std::string json(source->json());
+        Props copy(*source);
+        EXPECT_EQ(copy.json(), json);
+        EXPECT_EQ(copy.size(), source->size());
+
+        Props moved(std::move(copy));
+        EXPECT_EQ(moved.json(), json);
+        EXPECT_EQ(copy.json(), "{}");  // moved-from is empty and reusable
+        EXPECT_TRUE(copy.empty());
+        copy.add("again", 1);
+        EXPECT_EQ(copy.json(), R"({"again":1})");
+
+        Props assigned;
+        assigned.add("old", 1);
+        assigned = moved;
+        EXPECT_EQ(assigned.json(), json);
+        assigned = Props(*source);
+        EXPECT_EQ(assigned.json(), json);
+
+        // Still usable after being copied and moved around
+        assigned.add("more", true);
+        EXPECT_EQ(assigned.json(), json.substr(0, json.size() - 1) + R"(,"more":true})");
+    }
+    EXPECT_EQ(small.json(), small_json);
+    EXPECT_EQ(big.json(), big_json);
+}
+
 TEST(PropsTest, SizeTracking) {
     Props p;
     EXPECT_EQ(p.size(), 0u);
@@ -86,3 +195,116 @@ TEST(PropsTest, SizeTracking) {
     p.add("b", "2");
     EXPECT_EQ(p.size(), 2u);
 }
+
+TEST(PropsTest, StringViewKeysAndValues) {
+    // Views into a larger buffer: only their own bytes are written
+    const std::string text = "plan=pro\"tier";
+    std::string_view all = text;
+    std::string value = "std::string";
+    Props p;
+    p.add(all.substr(0, 4), all.substr(5));
+    p.add("literal", "const char*");
+    p.add(value, value);
+    p.add(std::string_view("view"), std::string_view("nul\0byte", 8));
+    EXPECT_EQ(p.json(), "{\"plan\":\"pro\\\"tier\",\"literal\":\"const char*\","
+                        "\"std::string\":\"std::string\",\"view\":\"nul\\u0000byte\"}");
+}
+
+TEST(PropsTest, NullCStringIsNull) {
+    const char* missing = nullptr;
+    const char* names[] = {"a", nullptr};
+    Props p;
+    p.add("missing", missing).add("names", names, 2);
+    EXPECT_EQ(p.json(), R"({"missing":null,"names":["a",null]})");
+}
+
+TEST(PropsTest, NestedObjectsAndArrays) {
+    Props p;
+    p.add("url", "/cart")
+     .begin_object("cart")
+         .add("items", 3)
+         .begin_array("skus").push("a-1").push("b\"2").end_array()
+         .begin_object("shipping").end_object()
+     .end_object()
+     .begin_array("matrix")
+         .begin_array().push(1).push(2).end_array()
+         .begin_array().end_array()
+         .begin_object().add("x", true).end_object()
+     .end_array()
+     .add("done", false);
+    EXPECT_EQ(p.json(), R"({"url":"/cart","cart":{"items":3,"skus":["a-1","b\"2"],"shipping":{}},)"
+                        R"("matrix":[[1,2],[],{"x":true}],"done":false})");
+    EXPECT_EQ(p.size(), 4u);
+}
+
+TEST(PropsTest, OpenContainersReadAsClosed) {
+    // The buffer is complete JSON after every call
+    Props p;
+    p.begin_object("a");
+    EXPECT_EQ(p.json(), R"({"a":{}})");
+    p.begin_array("b");
+    EXPECT_EQ(p.json(), R"({"a":{"b":[]}})");
+    p.push(1.5);
+    EXPECT_EQ(p.json(), R"({"a":{"b":[1.5]}})");
+    EXPECT_EQ(p.raw(), R"("a":{"b":[1.5]})");
+
+    // Mismatched and extra closes are ignored; keys inside arrays too
+    p.end_object().add("ignored_key", "v").end_array().end_object().end_object();
+    p.add("c", 1);
+    EXPECT_EQ(p.json(), R"({"a":{"b":[1.5,"v"]},"c":1})");
+
+    // Copies and moves carry the open containers
+    Props open;
+    open.begin_array("list").push(1);
+    Props copy = open;
+    copy.push(2).end_array().add("after", 3);
+    EXPECT_EQ(copy.json(), R"({"list":[1,2],"after":3})");
+    Props moved = std::move(open);
+    EXPECT_EQ(open.json(), "{}");
+    moved.push(4);
+    EXPECT_EQ(moved.json(), R"({"list":[1,4]})");
+    open.add("fresh", 1);
+    EXPECT_EQ(open.json(), R"({"fresh":1})");
+
+    // Past MAX_DEPTH, begins are ignored
+    Props deep;
+    for (size_t i = 0; i < Props::MAX_DEPTH + 6; i++) deep.begin_array("a");
+    deep.push(1);
+    std::string expected = "{\"a\":" + std::string(Props::MAX_DEPTH, '[') + "1" +
+                           std::string(Props::MAX_DEPTH, ']') + "}";
+    EXPECT_EQ(deep.json(), expected);
+
+    // ...and so are the ends that close them: the next end closes a real level
+    for (size_t i = 0; i < 6; i++) deep.end_array();
+    deep.push(2).end_array().push(3);
+    expected = "{\"a\":" + std::string(Props::MAX_DEPTH, '[') + "1,2],3" +
+               std::string(Props::MAX_DEPTH - 1, ']') + "}";
+    EXPECT_EQ(deep.json(), expected);
+    for (size_t i = 1; i < Props::MAX_DEPTH; i++) deep.end_array();
+    deep.add("b", 4);
+    expected = "{\"a\":" + std::string(Props::MAX_DEPTH, '[') + "1,2],3" +
+               std::string(Props::MAX_DEPTH - 1, ']') + ",\"b\":4}";
+    EXPECT_EQ(deep.json(), expected);
+    EXPECT_EQ(deep.size(), 2u);
+}
+
+TEST(PropsTest, TypedArrays) {
+    const int64_t ids[] = {1, -2, INT64_MAX};
+    std::vector<double> scores = {0.1, 2.5};
+    std::vector<std::string> names = {"a", "b\\c"};
+    std::vector<bool> flags = {true, false};
+    Props p;
+    p.add("ids", ids, 3)
+     .add("scores", scores)
+     .add("names", names)
+     .add("flags", flags)
+     .add("tags", {"x", "y"})
+     .add("ints", {1, 2, 3})
+     .add("none", ids, 0);
+    EXPECT_EQ(p.json(), R"({"ids":[1,-2,9223372036854775807],"scores":[0.1,2.5],"names":["a","b\\c"],)"
+                        R"("flags":[true,false],"tags":["x","y"],"ints":[1,2,3],"none":[]})");
+
+    // Inside an array a typed array is one nested element
+    auto nested = Props().begin_array("rows").add("", {1, 2}).push(3).end_array();
+    EXPECT_EQ(nested.json(), R"({"rows":[[1,2],3]})");
+}
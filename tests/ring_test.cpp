@@ -0,0 +1,91 @@
+// tests/ring_test.cpp
+// Unit tests for the lock-free worker channel ring.
+
+#include <gtest/gtest.h>
+#include "ring.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tell;
+
+TEST(RingTest, FifoOrder) {
+    RingBuffer<int> ring(4);
+    for (int i = 0; i < 4; i++) {
+        int v = i;
+        EXPECT_TRUE(ring.try_push(std::move(v)));
+    }
+    for (int i = 0; i < 4; i++) {
+        int out = -1;
+        EXPECT_TRUE(ring.try_pop(out));
+        EXPECT_EQ(out, i);
+    }
+    int out;
+    EXPECT_FALSE(ring.try_pop(out));
+}
+
+TEST(RingTest, FullRejectsPush) {
+    RingBuffer<int> ring(2);
+    int a = 1, b = 2, c = 3;
+    EXPECT_TRUE(ring.try_push(std::move(a)));
+    EXPECT_TRUE(ring.try_push(std::move(b)));
+    EXPECT_FALSE(ring.try_push(std::move(c)));
+    EXPECT_EQ(ring.size(), 2u);
+}
+
+TEST(RingTest, CapacityOneRoundsUpToTwo) {
+    RingBuffer<int> ring(1);
+    EXPECT_EQ(ring.capacity(), 2u);
+    int a = 1, b = 2, c = 3;
+    EXPECT_TRUE(ring.try_push(std::move(a)));
+    EXPECT_TRUE(ring.try_push(std::move(b)));
+    EXPECT_FALSE(ring.try_push(std::move(c)));
+    int out = 0;
+    EXPECT_TRUE(ring.try_pop(out));
+    EXPECT_EQ(out, 1);
+}
+
+TEST(RingTest, NonPowerOfTwoCapacityWraps) {
+    RingBuffer<std::string> ring(3);
+    for (int round = 0; round < 10; round++) {
+        std::string v = "item_" + std::to_string(round);
+        ASSERT_TRUE(ring.try_push(std::move(v)));
+        std::string out;
+        ASSERT_TRUE(ring.try_pop(out));
+        EXPECT_EQ(out, "item_" + std::to_string(round));
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingTest, ConcurrentProducersSingleConsumer) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 10000;
+    RingBuffer<int> ring(128);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; t++) {
+        producers.emplace_back([&ring]() {
+            for (int i = 0; i < kPerThread; i++) {
+                int v = i;
+                while (!ring.try_push(std::move(v))) std::this_thread::yield();
+            }
+        });
+    }
+
+    long long sum = 0;
+    int received = 0;
+    while (received < kThreads * kPerThread) {
+        int out;
+        if (ring.try_pop(out)) {
+            sum += out;
+            received++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : producers) t.join();
+
+    EXPECT_EQ(sum, static_cast<long long>(kThreads) * kPerThread * (kPerThread - 1) / 2);
+}